@@ -6,6 +6,8 @@ function usage() {
   -e DIR      Directory where AMAX is installed. (Default: $HOME/amax/X.Y)
   -c DIR      Directory where AMAX.CDT is installed. (Default: /usr/local/amax.cdt)
   -t          Build unit tests.
+  -n          Build host-native contracts and chain harness.
+  -s          Build contracts with DB operation counters (staging only).
   -y          Noninteractive mode (Uses defaults for each prompt.)
   -h          Print this help menu.
    \\n" "$0" 1>&2
@@ -13,9 +15,11 @@ function usage() {
 }
 
 BUILD_TESTS=false
+BUILD_NATIVE=false
+DB_STATS=false
 
 if [ $# -ne 0 ]; then
-  while getopts "e:c:tyh" opt; do
+  while getopts "e:c:tnsyh" opt; do
     case "${opt}" in
       e )
         AMAX_DIR_PROMPT=$OPTARG
@@ -26,6 +30,12 @@ if [ $# -ne 0 ]; then
       t )
         BUILD_TESTS=true
       ;;
+      n )
+        BUILD_NATIVE=true
+      ;;
+      s )
+        DB_STATS=true
+      ;;
       y )
         NONINTERACTIVE=true
         PROCEED=true
@@ -79,6 +89,6 @@ NC='\033[0m'
 CPU_CORES=$(getconf _NPROCESSORS_ONLN)
 mkdir -p build
 pushd build &> /dev/null
-cmake -DBUILD_TESTS=${BUILD_TESTS} ../
+cmake -DBUILD_TESTS=${BUILD_TESTS} -DBUILD_NATIVE=${BUILD_NATIVE} -DDB_STATS=${DB_STATS} ../
 make -j $CPU_CORES
 popd &> /dev/null
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <string>
 
 #include <verso.itoken/verso.itoken_db.hpp>
+#include <global_state.hpp>
 
 namespace amax {
 
@@ -29,12 +30,9 @@ class [[eosio::contract("verso.itoken")]] itoken : public contract {
       using contract::contract;
 
    itoken(eosio::name receiver, eosio::name code, datastream<const char*> ds): contract(receiver, code, ds),
-        _global(get_self(), get_self().value)
-    {
-        _gstate = _global.exists() ? _global.get() : global_t{};
-    }
+        _gstate(get_self()) {}
 
-    ~itoken() { _global.set( _gstate, get_self() ); }
+    ~itoken() noexcept(false) { _gstate.save(); }
 
    /**
     * @brief Allows `issuer` account to create a token in supply of `maximum_supply`. If validation is successful a new entry in statsta
@@ -96,7 +94,7 @@ class [[eosio::contract("verso.itoken")]] itoken : public contract {
       void sub_balance( const name& owner, const nasset& value );
 
    private:
-      global_singleton    _global;
-      global_t            _gstate;
+      dbstats::reporter   _dbstats;
+      common::global_state<global_singleton, global_t> _gstate;
 };
 } //namespace amax
@@ -61,10 +61,10 @@ void itoken::setnotary(const name& notary, const bool& to_add) {
    require_auth( _self );
 
    if (to_add)
-      _gstate.notaries.insert(notary);
+      _gstate.modify().notaries.insert(notary);
 
    else
-      _gstate.notaries.erase(notary);
+      _gstate.modify().notaries.erase(notary);
 
 }
 
@@ -72,16 +72,16 @@ void itoken::setwhitelist( const name& owner, const bool& to_add){
    require_auth( _self );
 
    if (to_add)
-      _gstate.whitelist.insert(owner);
+      _gstate.modify().whitelist.insert(owner);
 
    else
-      _gstate.whitelist.erase(owner);
+      _gstate.modify().whitelist.erase(owner);
 }
 
 
 void itoken::notarize(const name& notary, const uint32_t& token_id) {
    require_auth( notary );
-   check( _gstate.notaries.find(notary) != _gstate.notaries.end(), "not authorized notary" );
+   check( _gstate->notaries.find(notary) != _gstate->notaries.end(), "not authorized notary" );
 
    auto nstats = nstats_t::idx_t( _self, _self.value );
    auto itr = nstats.find( token_id );
@@ -173,7 +173,7 @@ void itoken::sub_balance( const name& owner, const nasset& value ) {
 
    const auto& from = from_acnts.get( value.symbol.raw(), "no balance object found" );
 
-   if ( _gstate.whitelist.find(owner) == _gstate.whitelist.end() ){
+   if ( _gstate->whitelist.find(owner) == _gstate->whitelist.end() ){
       check( from.balance.amount > value.amount, "overdrawn balance" );
       
    } else {
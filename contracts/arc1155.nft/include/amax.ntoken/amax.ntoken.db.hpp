@@ -6,6 +6,8 @@
 #include <eosio/system.hpp>
 #include <eosio/time.hpp>
 
+#include <dbstats.hpp>
+
 // #include <deque>
 #include <optional>
 #include <string>
@@ -27,7 +29,7 @@ NTBL("global") global_t {
 
     EOSLIB_SERIALIZE( global_t, (notaries) )
 };
-typedef eosio::singleton< "global"_n, global_t > global_singleton;
+typedef dbstats::singleton< "global"_n, global_t > global_singleton;
 
 struct nsymbol {
     uint32_t id;
@@ -45,7 +47,7 @@ struct nsymbol {
     EOSLIB_SERIALIZE( nsymbol, (id)(parent_id) )
 };
 
-bool operator==(const nsymbol& symb1, const nsymbol& symb2) { 
+inline bool operator==(const nsymbol& symb1, const nsymbol& symb2) { 
     return( symb1.id == symb2.id && symb1.parent_id == symb2.parent_id ); 
 }
 
@@ -97,7 +99,7 @@ TBL nstats_t {
     uint128_t by_issuer_created()const { return (uint128_t) issuer.value << 64 | (uint128_t) issued_at.sec_since_epoch(); }
     checksum256 by_token_uri()const { return HASH256(token_uri); } // unique index
 
-    typedef eosio::multi_index
+    typedef dbstats::multi_index
     < "tokenstats"_n,  nstats_t,
         indexed_by<"parentidx"_n,       const_mem_fun<nstats_t, uint64_t, &nstats_t::by_parent_id> >,
         indexed_by<"ipowneridx"_n,      const_mem_fun<nstats_t, uint64_t, &nstats_t::by_ipowner> >,
@@ -121,7 +123,7 @@ TBL account_t {
 
     EOSLIB_SERIALIZE(account_t, (balance)(paused) )
 
-    typedef eosio::multi_index< "accounts"_n, account_t > idx_t;
+    typedef dbstats::multi_index< "accounts"_n, account_t > idx_t;
 };
 
 
@@ -135,7 +137,7 @@ TBL allowance_t{
 
     EOSLIB_SERIALIZE(allowance_t, (spender)(allowances) )
 
-    typedef eosio::multi_index< "allowances"_n, allowance_t > idx_t;
+    typedef dbstats::multi_index< "allowances"_n, allowance_t > idx_t;
 };
 
 } //namespace amax
\ No newline at end of file
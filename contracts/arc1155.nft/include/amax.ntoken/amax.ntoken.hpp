@@ -7,6 +7,8 @@
 #include <string>
 
 #include <amax.ntoken/amax.ntoken.db.hpp>
+#include <global_state.hpp>
+#include <table_registry.hpp>
 
 namespace amax {
 
@@ -31,12 +33,9 @@ class [[eosio::contract("amax.ntoken")]] ntoken : public contract {
       using contract::contract;
 
    ntoken(eosio::name receiver, eosio::name code, datastream<const char*> ds): contract(receiver, code, ds),
-        _global(get_self(), get_self().value)
-    {
-        _gstate = _global.exists() ? _global.get() : global_t{};
-    }
+        _gstate(get_self()), _tables(get_self()) {}
 
-    ~ntoken() { _global.set( _gstate, get_self() ); }
+    ~ntoken() noexcept(false) { _gstate.save(); }
 
    /**
     * @brief Allows `issuer` account to create a token in supply of `maximum_supply`. If validation is successful a new entry in statsta
@@ -122,7 +121,8 @@ class [[eosio::contract("amax.ntoken")]] ntoken : public contract {
       void sub_balance( const name& owner, const nasset& value );
 
    private:
-      global_singleton    _global;
-      global_t            _gstate;
+      dbstats::reporter   _dbstats;
+      common::global_state<global_singleton, global_t> _gstate;
+      common::table_registry _tables;
 };
 } //namespace amax
@@ -40,16 +40,16 @@ void ntoken::setnotary(const name& notary, const bool& to_add) {
    require_auth( _self );
 
    if (to_add)
-      _gstate.notaries.insert(notary);
+      _gstate.modify().notaries.insert(notary);
 
    else
-      _gstate.notaries.erase(notary);
+      _gstate.modify().notaries.erase(notary);
 
 }
 
 void ntoken::notarize(const name& notary, const uint32_t& token_id) {
    require_auth( notary );
-   check( _gstate.notaries.find(notary) != _gstate.notaries.end(), "not authorized notary" );
+   check( _gstate->notaries.find(notary) != _gstate->notaries.end(), "not authorized notary" );
 
    auto nstats = nstats_t::idx_t( _self, _self.value );
    auto itr = nstats.find( token_id );
@@ -141,9 +141,9 @@ void ntoken::transfer( const name& from, const name& to, const vector<nasset>& a
    require_recipient( from );
    require_recipient( to );
 
+   auto& nstats = _tables.get<nstats_t::idx_t>( _self.value );
    for( auto& quantity : assets) {
       auto sym = quantity.symbol;
-      auto nstats = nstats_t::idx_t( _self, _self.value );
       const auto& st = nstats.get( sym.id );
 
 
@@ -174,8 +174,8 @@ void ntoken::transferfrom( const name& owner, const name& from, const name& to,
    require_recipient( from );
    require_recipient( to );
 
+   auto& nstats = _tables.get<nstats_t::idx_t>( _self.value );
    for( auto& nft : assets) {
-      auto nstats = nstats_t::idx_t( _self, _self.value );
       const auto& st = nstats.get( nft.symbol.id );
       
       check( nft.is_valid(), "invalid nft" );
@@ -195,7 +195,7 @@ void ntoken::transferfrom( const name& owner, const name& from, const name& to,
 }
 
 void ntoken::sub_balance( const name& owner, const nasset& value ) {
-   auto from_acnts = account_t::idx_t( get_self(), owner.value );
+   auto& from_acnts = _tables.get<account_t::idx_t>( owner.value );
 
    const auto& from = from_acnts.get( value.symbol.raw(), "no balance object found" );
    check( from.balance.amount >= value.amount, "overdrawn balance" );
@@ -207,7 +207,7 @@ void ntoken::sub_balance( const name& owner, const nasset& value ) {
 
 void ntoken::add_balance( const name& owner, const nasset& value, const name& ram_payer )
 {
-   auto to_acnts = account_t::idx_t( get_self(), owner.value );
+   auto& to_acnts = _tables.get<account_t::idx_t>( owner.value );
    auto to = to_acnts.find( value.symbol.raw() );
    if( to == to_acnts.end() ) {
       to_acnts.emplace( ram_payer, [&]( auto& a ){
@@ -253,28 +253,29 @@ void ntoken::add_balance( const name& owner, const nasset& value, const name& ra
 
 
 void ntoken::pausetoken(const uint64_t& token_id, const bool paused) {
-   require_auth( _gstate.admin );
-
-   auto stats = nstats_t(token_id);
-   CHECKC( _db.get(stats), err::RECORD_NOT_FOUND, "token not found: " + to_string(token_id) )
-   CHECKC( stats.paused != paused, err::PARAM_INCORRECT, "already paused: " + to_string(paused) )
+   require_auth( _self );
 
-   stats.paused = paused;
-   _db.set( stats );
+   auto nstats = nstats_t::idx_t( _self, _self.value );
+   auto itr = nstats.find( token_id );
+   check( itr != nstats.end(), "token not found: " + to_string(token_id) );
+   check( itr->paused != paused, "already paused: " + to_string(paused) );
 
+   nstats.modify( itr, same_payer, [&]( auto& row ) {
+      row.paused = paused;
+   });
 }
 
 void ntoken::pauseaccount(const name& target, const nsymbol& symbol, const bool paused) {
-   require_auth( _gstate.admin );
+   require_auth( _self );
 
-   auto tokenasset = nasset(0, symbol);
-   auto account = account_t(tokenasset);
-   CHECKC( _db.get(target.value, account), err::RECORD_NOT_FOUND, "account balance not found: " + target.to_string() )
-   CHECKC( account.paused != paused, err::PARAM_INCORRECT, "already paused: " + to_string(paused) )
-      
-   account.paused = paused;
-   _db.set( target.value, account );
+   auto acnts = account_t::idx_t( _self, target.value );
+   auto itr = acnts.find( symbol.raw() );
+   check( itr != acnts.end(), "account balance not found: " + target.to_string() );
+   check( itr->paused != paused, "already paused: " + to_string(paused) );
 
+   acnts.modify( itr, same_payer, [&]( auto& row ) {
+      row.paused = paused;
+   });
 }
 
 } //namespace amax
\ No newline at end of file
@@ -3,6 +3,11 @@
 #include <eosio/asset.hpp>
 #include <eosio/eosio.hpp>
 
+#include <dbstats.hpp>
+#include <table_registry.hpp>
+
+#include <algorithm>
+#include <map>
 #include <string>
 
 namespace eosiosystem {
@@ -13,6 +18,50 @@ namespace eosio {
 
    using std::string;
 
+   /**
+    * One payout of a `transfers` or `distribute` batch.
+    */
+   struct transfer_param {
+      name     to;
+      asset    quantity;
+      string   memo;
+   };
+
+   /**
+    * One transfer of a `settle` batch.
+    */
+   struct settle_param {
+      name     from;
+      name     to;
+      asset    quantity;
+      string   memo;
+   };
+
+   /**
+    * A balance returned by `getbalances`.
+    */
+   struct balance_info {
+      name     owner;
+      asset    balance;
+   };
+
+   /**
+    * A token returned by `getsupplies`.
+    */
+   struct supply_info {
+      asset    supply;
+      asset    max_supply;
+      name     issuer;
+   };
+
+   /**
+    * The holders of a token returned by `getholders`.
+    */
+   struct holders_info {
+      uint64_t                   holders;
+      std::vector<balance_info>  top;
+   };
+
    /**
     * The `amax.token` sample system contract defines the structures and actions that allow users to create, issue, and manage tokens for AMAX based blockchains. It demonstrates one way to implement a smart contract which allows for creation and management of tokens. It is possible for one to create a similar contract which suits different needs. However, it is recommended that if one only needs a token with the below listed actions, that one uses the `amax.token` contract instead of developing their own.
     * 
@@ -60,6 +109,20 @@ namespace eosio {
          [[eosio::action]]
          void retire( const asset& quantity, const string& memo );
 
+         /**
+          * Issues new tokens straight into many accounts, e.g. for an airdrop. The supply is
+          * checked against the max supply and increased once for the whole chunk, then each
+          * recipient is credited and notified. Large distributions are pushed in chunks of up
+          * to `max_distribute_rows` payouts.
+          *
+          * @param payouts - the recipients with their quantities and memos.
+          *
+          * @pre All quantities must be of the same token, and the action must be authorized by its issuer,
+          * @pre Recipients must not be blacklisted.
+          */
+         [[eosio::action]]
+         void distribute( const std::vector<transfer_param>& payouts );
+
          /**
           * Allows `from` account to transfer to `to` account the `quantity` tokens.
           * One account is debited and the other is credited with quantity tokens.
@@ -74,6 +137,38 @@ namespace eosio {
                         const name&    to,
                         const asset&   quantity,
                         const string&  memo );
+
+         /**
+          * Allows `from` account to transfer tokens of one symbol to many accounts in one action.
+          * The symbol and `from` are validated once and `from` is debited once with the total,
+          * then each recipient is credited. `from` and the recipients are notified of this
+          * `transfers` action, not of a `transfer` per recipient: contracts that react to incoming
+          * `transfer` notifications do not see these payouts unless they also handle `transfers`.
+          *
+          * @param from - the account to transfer from,
+          * @param transfers - the recipients with their quantities and memos, at most `max_transfer_rows`.
+          *
+          * @pre All quantities must be of the same token,
+          * @pre `from` must not be blacklisted.
+          */
+         [[eosio::action]]
+         void transfers( const name& from, const std::vector<transfer_param>& transfers );
+
+         /**
+          * Settles a batch of transfers of one symbol between many accounts by their net result:
+          * the transfers are summed per account and each account's balance is written once with
+          * its net change, so the cost follows the number of distinct accounts rather than the
+          * number of transfers. Every sender must authorize the action and every account is
+          * notified once. Overdraft is checked on the net result of each account.
+          *
+          * @param transfers - the transfers to settle, at most `max_settle_transfers`.
+          *
+          * @pre All quantities must be of the same token,
+          * @pre No account of the batch may be blacklisted.
+          */
+         [[eosio::action]]
+         void settle( const std::vector<settle_param>& transfers );
+
          /**
           * Allows `ram_payer` to create an account `owner` with zero balance for
           * token `symbol` at the expense of `ram_payer`.
@@ -88,6 +183,32 @@ namespace eosio {
          [[eosio::action]]
          void open( const name& owner, const symbol& symbol, const name& ram_payer );
 
+         /**
+          * Allows `ram_payer` to open zero balances of token `symbol` for many accounts in one
+          * action, e.g. ahead of an airdrop. Owners that already hold a balance are skipped.
+          * A balance opened for another account remembers `ram_payer` as its opener, so that
+          * `ram_payer` can reclaim it with `sweep` while it is left empty and still paid by it.
+          *
+          * @param owners - the accounts to open balances for, at most `max_open_rows`,
+          * @param symbol - the token to open,
+          * @param ram_payer - the account that supports the cost of this action.
+          */
+         [[eosio::action]]
+         void openmany( const std::vector<name>& owners, const symbol& symbol, const name& ram_payer );
+
+         /**
+          * Closes the zero balances of token `symbol` of `owners`, reclaiming their RAM. A balance
+          * is closed if `caller` is its owner, or if `caller` opened it with `openmany` and still
+          * pays for it; once the owner has sent tokens from it the owner pays for the row and only
+          * the owner can close it. Other balances, and those not at zero, are skipped.
+          *
+          * @param caller - the owner or the opener of the balances,
+          * @param symbol - the token of the balances,
+          * @param owners - the accounts whose balances to close, at most `max_sweep_rows`.
+          */
+         [[eosio::action]]
+         void sweep( const name& caller, const symbol& symbol, const std::vector<name>& owners );
+
          /**
           * This action is the opposite for open, it closes the account `owner`
           * for token `symbol`.
@@ -104,6 +225,82 @@ namespace eosio {
          [[eosio::action]]
          void blacklist( const std::vector<name>& targets, const bool& to_add );
 
+         /**
+          * Stages a large blacklist update, applied in order by `applyblack`. Each account is
+          * staged as its own row, paid by the contract until it is applied; stage more than
+          * `max_staged_targets` accounts over several actions.
+          *
+          * @param targets - up to `max_staged_targets` accounts to add or remove,
+          * @param to_add - whether the accounts are added to or removed from the blacklist.
+          */
+         [[eosio::action]]
+         void stageblack( const std::vector<name>& targets, const bool& to_add );
+
+         /**
+          * Applies at most `max_rows` staged blacklist changes in the order they were staged,
+          * erasing each one once applied. It requires no authorization: the changes were
+          * authorized by `stageblack` and applying them is idempotent, so anyone can push it
+          * to drain the staged rows.
+          *
+          * @param max_rows - the number of accounts to process, up to `max_apply_rows`.
+          */
+         [[eosio::action]]
+         void applyblack( const uint32_t& max_rows );
+
+         /**
+          * Read-only query of the balances of `owners` in each of `symbols`, so that a wallet loads
+          * them in one round trip. Balances that do not exist are left out. Nothing is written and
+          * no authorization is required.
+          *
+          * @param owners - the accounts to query,
+          * @param symbols - the tokens to query.
+          *
+          * @pre At most `max_query_rows` owners, symbols and owner and symbol pairs.
+          */
+         [[eosio::action]]
+         std::vector<balance_info> getbalances( const std::vector<name>& owners, const std::vector<symbol_code>& symbols );
+
+         /**
+          * Read-only query of the supply, max supply and issuer of `symbols`. Tokens that do not
+          * exist are left out.
+          *
+          * @param symbols - the tokens to query, at most `max_query_rows`.
+          */
+         [[eosio::action]]
+         std::vector<supply_info> getsupplies( const std::vector<symbol_code>& symbols );
+
+         /**
+          * Read-only query of the number of accounts holding a positive balance of `symbol` and of
+          * its largest holders, largest first. Both are kept up to date on every balance change,
+          * so the query reads two small tables instead of every account scope.
+          *
+          * The holder count is exact, the top list is approximate: a listed balance that shrinks
+          * stays listed until a larger balance that changes displaces it, and an unlisted balance
+          * only enters the list when it changes. The listed balances themselves are current.
+          *
+          * @param symbol - the token to query,
+          * @param limit - the number of top holders to return, at most `max_top_holders`.
+          *
+          * @pre the holders of `symbol` are initialized: it was created with this contract version,
+          *      or `seedholders` counted its existing balances.
+          */
+         [[eosio::action]]
+         holders_info getholders( const symbol_code& symbol, const uint32_t& limit );
+
+         /**
+          * Counts the existing balances of a token created before holders were tracked. The
+          * contract account walks the account scopes off-chain and passes the owners in ascending
+          * order, at most `max_seed_rows` per action; each call resumes after the last owner
+          * of the previous one. Balance changes of owners already counted are tracked as
+          * usual, the others are read when their turn comes.
+          *
+          * @param symbol - the token to seed,
+          * @param owners - the next owners in ascending name order, with or without a balance of `symbol`,
+          * @param last - whether these are the last owners, after which `getholders` answers.
+          */
+         [[eosio::action]]
+         void seedholders( const symbol_code& symbol, const std::vector<name>& owners, const bool& last );
+
          static asset get_supply( const name& token_contract_account, const symbol_code& sym_code )
          {
             stats statstable( token_contract_account, sym_code.raw() );
@@ -126,12 +323,19 @@ namespace eosio {
          using create_action = eosio::action_wrapper<"create"_n, &token::create>;
          using issue_action = eosio::action_wrapper<"issue"_n, &token::issue>;
          using retire_action = eosio::action_wrapper<"retire"_n, &token::retire>;
+         using distribute_action = eosio::action_wrapper<"distribute"_n, &token::distribute>;
          using transfer_action = eosio::action_wrapper<"transfer"_n, &token::transfer>;
+         using transfers_action = eosio::action_wrapper<"transfers"_n, &token::transfers>;
+         using settle_action = eosio::action_wrapper<"settle"_n, &token::settle>;
          using open_action = eosio::action_wrapper<"open"_n, &token::open>;
+         using openmany_action = eosio::action_wrapper<"openmany"_n, &token::openmany>;
+         using sweep_action = eosio::action_wrapper<"sweep"_n, &token::sweep>;
          using close_action = eosio::action_wrapper<"close"_n, &token::close>;
+         using seedholders_action = eosio::action_wrapper<"seedholders"_n, &token::seedholders>;
       private:
          struct [[eosio::table]] account {
-            asset    balance;
+            asset                   balance;
+            binary_extension<name>  opener;     //`openmany` account paying for the row, until the owner pays
 
             uint64_t primary_key()const { return balance.symbol.code().raw(); }
          };
@@ -150,12 +354,72 @@ namespace eosio {
             uint64_t primary_key()const { return account.value; }
          };
 
-         typedef eosio::multi_index< "accounts"_n, account > accounts;
-         typedef eosio::multi_index< "stat"_n, currency_stats > stats;
-         typedef eosio::multi_index< "blacklist"_n, blacklist_t > blackaccounts;
+         typedef dbstats::multi_index< "accounts"_n, account > accounts;
+         typedef dbstats::multi_index< "stat"_n, currency_stats > stats;
+         /// blacklist change staged by `stageblack`, erased by `applyblack` once applied
+         struct [[eosio::table]] blackstage_t {
+            uint64_t id;
+            name     target;
+            bool     to_add;
+
+            uint64_t primary_key()const { return id; }
+         };
+
+         typedef dbstats::multi_index< "blacklist"_n, blacklist_t > blackaccounts;
+         typedef dbstats::multi_index< "blackstage"_n, blackstage_t > blackstages;
+         /// number of holders of a token, scoped to the symbol code
+         struct [[eosio::table]] holder_stats {
+            uint64_t holders     = 0;       //accounts with a positive balance
+            uint64_t tracked     = 0;       //rows in `topholders`
+            int64_t  min_listed  = 0;       //no listed balance is lower while `topholders` is full
+            bool     initialized = false;   //every balance is counted, set by `create` or the last `seedholders`
+            name     seeded;                //owners up to this one are counted while seeding
+         };
+
+         /// one of the `max_top_holders` largest balances of a token, scoped to the symbol code.
+         /// A balance that shrinks stays listed until a larger balance that changes displaces it.
+         struct [[eosio::table]] top_holder {
+            name     owner;
+            asset    balance;
+
+            uint64_t primary_key()const { return owner.value; }
+            uint64_t by_balance()const { return (uint64_t)balance.amount; }
+         };
+
+         typedef dbstats::singleton< "holderstats"_n, holder_stats > holderstats;
+         typedef dbstats::multi_index< "topholders"_n, top_holder,
+            indexed_by<"bybalance"_n, const_mem_fun<top_holder, uint64_t, &top_holder::by_balance> >
+         > topholders;
+
+         static constexpr uint32_t max_staged_targets = 500;
+         static constexpr uint32_t max_apply_rows     = 500;
+         static constexpr uint32_t max_query_rows     = 1000;
+         static constexpr uint32_t max_distribute_rows = 500;
+         static constexpr uint32_t max_transfer_rows  = 500;
+         static constexpr uint32_t max_open_rows      = 500;
+         static constexpr uint32_t max_sweep_rows     = 500;
+         static constexpr uint32_t max_top_holders    = 100;
+         static constexpr uint32_t max_seed_rows      = 500;
+         static constexpr uint32_t max_settle_transfers = 1000;
+
+         dbstats::reporter _dbstats;
+         common::table_registry _tables{ get_self() };
+
+#ifdef TOKEN_SYMBOL_CODE
+         /// single-symbol build (cmake -DTOKEN_SYMBOL=8,AMAX): the symbol is checked
+         /// statically and open never reads the stats row
+         static constexpr symbol single_symbol = symbol( symbol_code( TOKEN_SYMBOL_CODE ), TOKEN_SYMBOL_PRECISION );
+#endif
 
+         /// checks `sym` against the stats row, or against `single_symbol`
+         void check_symbol( const symbol& sym );
+         /// also checks the symbol precision against the owner's row
          void sub_balance( const name& owner, const asset& value );
          void add_balance( const name& owner, const asset& value, const name& ram_payer );
+         /// updates the holder count and top holders after the balance of `owner` went from `before` to `after`
+         void track_holder( const name& owner, const asset& before, const asset& after );
+         /// lists an unlisted positive balance if it is among the largest, returns whether `hs` changed
+         bool list_holder( topholders& tops, holder_stats& hs, const name& owner, const asset& balance );
    };
 
 }
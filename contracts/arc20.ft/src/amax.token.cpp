@@ -10,6 +10,9 @@ void token::create( const name&   issuer,
     check(is_account(issuer), "issuer account does not exist");
     auto sym = maximum_supply.symbol;
     check( sym.is_valid(), "invalid symbol name" );
+#ifdef TOKEN_SYMBOL_CODE
+    check( sym == single_symbol, "this build only supports " + single_symbol.code().to_string() );
+#endif
     check( maximum_supply.is_valid(), "invalid supply");
     check( maximum_supply.amount > 0, "max-supply must be positive");
 
@@ -22,6 +25,12 @@ void token::create( const name&   issuer,
        s.max_supply    = maximum_supply;
        s.issuer        = issuer;
     });
+
+    // a new token has no balances to count
+    holderstats hstats( get_self(), sym.code().raw() );
+    holder_stats hs;
+    hs.initialized = true;
+    hstats.set( hs, get_self() );
 }
 
 
@@ -75,6 +84,46 @@ void token::retire( const asset& quantity, const string& memo )
     sub_balance( st.issuer, quantity );
 }
 
+void token::distribute( const std::vector<transfer_param>& payouts )
+{
+    check( payouts.size() > 0, "no payouts" );
+    check( payouts.size() <= max_distribute_rows, "too many payouts: " + std::to_string( payouts.size() ) );
+
+    auto sym = payouts.front().quantity.symbol;
+    check( sym.is_valid(), "invalid symbol name" );
+
+    auto& statstable = _tables.get<stats>( sym.code().raw() );
+    auto existing = statstable.find( sym.code().raw() );
+    check( existing != statstable.end(), "token with symbol does not exist, create token before issue" );
+    const auto& st = *existing;
+
+    require_auth( st.issuer );
+    check( sym == st.supply.symbol, "symbol precision mismatch" );
+
+    auto total = asset( 0, sym );
+    for (const auto& p : payouts) {
+       check( p.quantity.is_valid(), "invalid quantity" );
+       check( p.quantity.amount > 0, "must issue positive quantity" );
+       check( p.quantity.symbol == sym, "symbol precision mismatch" );
+       check( p.memo.size() <= 256, "memo has more than 256 bytes" );
+       total += p.quantity;
+    }
+    check( total.amount <= st.max_supply.amount - st.supply.amount, "quantity exceeds available supply");
+
+    statstable.modify( st, same_payer, [&]( auto& s ) {
+       s.supply += total;
+    });
+
+    auto& black_accts = _tables.get<blackaccounts>( _self.value );
+    for (const auto& p : payouts) {
+       check( is_account( p.to ), "to account does not exist");
+       check( black_accts.find( p.to.value ) == black_accts.end(), "to acccount blacklisted!" );
+
+       require_recipient( p.to );
+       add_balance( p.to, p.quantity, st.issuer );
+    }
+}
+
 void token::blacklist( const std::vector<name>& targets, const bool& to_add ){
    check( has_auth( _self ) || has_auth( "armoniaadmin"_n ), "not authorized" );
    check( targets.size() <= 50, "overiszed targets: " + std::to_string( targets.size()) );
@@ -101,6 +150,43 @@ void token::blacklist( const std::vector<name>& targets, const bool& to_add ){
    }
 }
 
+void token::stageblack( const std::vector<name>& targets, const bool& to_add ) {
+   check( has_auth( _self ) || has_auth( "armoniaadmin"_n ), "not authorized" );
+   check( targets.size() > 0, "no targets" );
+   check( targets.size() <= max_staged_targets, "overiszed targets: " + std::to_string( targets.size()) );
+
+   blackstages stages( _self, _self.value );
+   auto id = stages.available_primary_key();
+   for (auto& target : targets) {
+      stages.emplace( _self, [&]( auto& s ){
+         s.id        = id++;
+         s.target    = target;
+         s.to_add    = to_add;
+      });
+   }
+}
+
+void token::applyblack( const uint32_t& max_rows ) {
+   check( max_rows > 0 && max_rows <= max_apply_rows, "max_rows must be within [1, " + std::to_string( max_apply_rows ) + "]" );
+
+   blackstages stages( _self, _self.value );
+   auto stage = stages.begin();
+   check( stage != stages.end(), "no staged blacklist change" );
+
+   auto& black_accts = _tables.get<blackaccounts>( _self.value );
+   for (uint32_t rows = 0; stage != stages.end() && rows < max_rows; ++rows) {
+      auto itr = black_accts.find( stage->target.value );
+      if (stage->to_add && itr == black_accts.end()) {
+         black_accts.emplace( _self, [&]( auto& a ){
+            a.account = stage->target;
+         });
+      } else if (!stage->to_add && itr != black_accts.end()) {
+         black_accts.erase( itr );
+      }
+      stage = stages.erase( stage );
+   }
+}
+
 void token::transfer( const name&    from,
                       const name&    to,
                       const asset&   quantity,
@@ -115,33 +201,42 @@ void token::transfer( const name&    from,
    
    require_auth( from );
 
-   blackaccounts black_accts( _self, _self.value );
+   auto& black_accts = _tables.get<blackaccounts>( _self.value );
 
    check( is_account( to ), "to account does not exist");
-   check( black_accts.find( to.value ) == black_accts.end(), "to acccount blacklisted!" );
 
-   auto from_black_itr = black_accts.find( from.value );
+   // one ordered probe clears both accounts unless a blacklisted account sorts between them,
+   // in particular when nobody is blacklisted. The lower account is blacklisted iff it is the
+   // account found, so only the higher one may need a second lookup.
+   const auto& lo = from < to ? from : to;
+   const auto& hi = from < to ? to : from;
+   auto lo_black_itr = black_accts.end();
+   auto hi_black_itr = black_accts.end();
+   auto black_itr = black_accts.lower_bound( lo.value );
+   if ( black_itr != black_accts.end() && !( hi < black_itr->account ) ) {
+      if ( black_itr->account == lo )
+         lo_black_itr = black_itr;
+      hi_black_itr = black_itr->account == hi ? black_itr : black_accts.find( hi.value );
+   }
+   const auto& from_black_itr = from < to ? lo_black_itr : hi_black_itr;
+   check( ( from < to ? hi_black_itr : lo_black_itr ) == black_accts.end(), "to acccount blacklisted!" );
+
    auto from_blacklisted = ( from_black_itr != black_accts.end() );
    if (from_blacklisted) {
       check( to == "aaaaaaaaaaaa"_n, "blacklisted account can only transfer to `aaaaaaaaaaaa`!" );
 
-      accounts accountstable( _self, from.value );
+      auto& accountstable = _tables.get<accounts>( from.value );
       const auto& ac = accountstable.get( symbol_code("AMAX").raw() );
       if (ac.balance == quantity) {
          black_accts.erase( from_black_itr );
       }
    }
 
-   auto sym = quantity.symbol.code();
-   stats statstable( get_self(), sym.raw() );
-   const auto& st = statstable.get( sym.raw() );
-
    require_recipient( from );
    require_recipient( to );
 
    check( quantity.is_valid(), "invalid quantity" );
    check( quantity.amount > 0, "must transfer positive quantity" );
-   check( quantity.symbol == st.supply.symbol, "symbol precision mismatch" );
    check( memo.size() <= 256, "memo has more than 256 bytes" );
 
    auto payer = has_auth( to ) ? to : from;
@@ -150,32 +245,210 @@ void token::transfer( const name&    from,
    add_balance( to, quantity, payer );
 }
 
+void token::transfers( const name& from, const std::vector<transfer_param>& transfers )
+{
+   require_auth( from );
+   check( transfers.size() > 0, "no transfers" );
+   check( transfers.size() <= max_transfer_rows, "too many transfers: " + std::to_string( transfers.size() ) );
+
+   auto& black_accts = _tables.get<blackaccounts>( _self.value );
+   check( black_accts.find( from.value ) == black_accts.end(), "blacklisted account cannot batch transfer" );
+
+   auto sym = transfers.front().quantity.symbol;
+
+   require_recipient( from );
+
+   auto total = asset( 0, sym );
+   for (const auto& t : transfers) {
+      check( from != t.to, "cannot transfer to self" );
+      if ( from == "aaaaaaaaaaaa"_n )
+         check( t.to == "amax"_n, "can only transfer to amax" );
+
+      check( t.quantity.is_valid(), "invalid quantity" );
+      check( t.quantity.amount > 0, "must transfer positive quantity" );
+      check( t.quantity.symbol == sym, "symbol precision mismatch" );
+      check( t.memo.size() <= 256, "memo has more than 256 bytes" );
+      total += t.quantity;
+   }
+
+   sub_balance( from, total );
+
+   for (const auto& t : transfers) {
+      check( is_account( t.to ), "to account does not exist");
+      check( black_accts.find( t.to.value ) == black_accts.end(), "to acccount blacklisted!" );
+
+      require_recipient( t.to );
+      add_balance( t.to, t.quantity, has_auth( t.to ) ? t.to : from );
+   }
+}
+
+void token::settle( const std::vector<settle_param>& transfers )
+{
+   check( transfers.size() > 0, "no transfers" );
+   check( transfers.size() <= max_settle_transfers, "too many transfers: " + std::to_string( transfers.size() ) );
+
+   auto sym = transfers.front().quantity.symbol;
+
+   struct net_t {
+      asset    delta;
+      name     ram_payer;  //the first sender to the account
+      bool     sender;
+   };
+   std::map<name, net_t> nets;
+   for (const auto& t : transfers) {
+      check( t.from != t.to, "cannot transfer to self" );
+      if ( t.from == "aaaaaaaaaaaa"_n )
+         check( t.to == "amax"_n, "can only transfer to amax" );
+
+      check( t.quantity.is_valid(), "invalid quantity" );
+      check( t.quantity.amount > 0, "must transfer positive quantity" );
+      check( t.quantity.symbol == sym, "symbol precision mismatch" );
+      check( t.memo.size() <= 256, "memo has more than 256 bytes" );
+
+      auto& from = nets.emplace( t.from, net_t{ asset( 0, sym ), t.from, true } ).first->second;
+      auto& to = nets.emplace( t.to, net_t{ asset( 0, sym ), t.from, false } ).first->second;
+      from.delta -= t.quantity;
+      from.sender = true;
+      to.delta += t.quantity;
+   }
+
+   auto& black_accts = _tables.get<blackaccounts>( _self.value );
+   for (const auto& n : nets) {
+      if (n.second.sender)
+         require_auth( n.first );
+      check( is_account( n.first ), "account does not exist: " + n.first.to_string() );
+      check( black_accts.find( n.first.value ) == black_accts.end(), "account blacklisted: " + n.first.to_string() );
+
+      require_recipient( n.first );
+   }
+
+   // debits first; the deltas sum up to zero, so any credit comes with a debit checking the symbol
+   for (const auto& n : nets) {
+      if (n.second.delta.amount < 0)
+         sub_balance( n.first, -n.second.delta );
+   }
+   for (const auto& n : nets) {
+      if (n.second.delta.amount > 0)
+         add_balance( n.first, n.second.delta, has_auth( n.first ) ? n.first : n.second.ram_payer );
+   }
+}
+
+void token::check_symbol( const symbol& sym ) {
+#ifdef TOKEN_SYMBOL_CODE
+   check( sym == single_symbol, "symbol precision mismatch" );
+#else
+   auto& statstable = _tables.get<stats>( sym.code().raw() );
+   const auto& st = statstable.get( sym.code().raw(), "symbol does not exist" );
+   check( sym == st.supply.symbol, "symbol precision mismatch" );
+#endif
+}
+
 void token::sub_balance( const name& owner, const asset& value ) {
-   accounts from_acnts( get_self(), owner.value );
+   auto& from_acnts = _tables.get<accounts>( owner.value );
 
+   // the row was created with the token's symbol, so it stands in for the stats row
    const auto& from = from_acnts.get( value.symbol.code().raw(), "no balance object found" );
+   check( from.balance.symbol == value.symbol, "symbol precision mismatch" );
    check( from.balance.amount >= value.amount, "overdrawn balance" );
 
+   // the owner pays for the row from now on, so its opener can no longer sweep it
+   const auto before = from.balance;
    from_acnts.modify( from, owner, [&]( auto& a ) {
          a.balance -= value;
+         a.opener.reset();
       });
+
+   track_holder( owner, before, from.balance );
 }
 
 void token::add_balance( const name& owner, const asset& value, const name& ram_payer )
 {
-   accounts to_acnts( get_self(), owner.value );
+   auto& to_acnts = _tables.get<accounts>( owner.value );
    auto to = to_acnts.find( value.symbol.code().raw() );
    if( to == to_acnts.end() ) {
       to_acnts.emplace( ram_payer, [&]( auto& a ){
         a.balance = value;
       });
+      track_holder( owner, asset( 0, value.symbol ), value );
    } else {
+      const auto before = to->balance;
       to_acnts.modify( to, same_payer, [&]( auto& a ) {
         a.balance += value;
       });
+      track_holder( owner, before, to->balance );
    }
 }
 
+void token::track_holder( const name& owner, const asset& before, const asset& after )
+{
+   auto sym_code_raw = after.symbol.code().raw();
+   auto& hstats = _tables.get<holderstats>( sym_code_raw );
+   auto hs = hstats.get_or_default();
+   if (!hs.initialized && hs.seeded < owner)
+      return;   //counted by `seedholders` later on
+
+   bool crossed = ( before.amount > 0 ) != ( after.amount > 0 );
+   auto changed = crossed;
+   if (crossed && after.amount > 0) {
+      ++hs.holders;
+   } else if (crossed) {
+      check( hs.holders > 0, "holder count underflow of " + after.symbol.code().to_string() );
+      --hs.holders;
+   }
+
+   // a balance below the smallest listed one is not listed, so most transfers stop here
+   bool full = hs.tracked >= max_top_holders;
+   if (before.amount <= 0 || ( full && before.amount < hs.min_listed )) {
+      if (after.amount > 0 && !( full && after.amount <= hs.min_listed ))
+         changed |= list_holder( _tables.get<topholders>( sym_code_raw ), hs, owner, after );
+   } else {
+      auto& tops = _tables.get<topholders>( sym_code_raw );
+      auto top = tops.find( owner.value );
+      if (top == tops.end()) {
+         if (after.amount > 0 && !( full && after.amount <= hs.min_listed ))
+            changed |= list_holder( tops, hs, owner, after );
+      } else if (after.amount > 0) {
+         tops.modify( top, same_payer, [&]( auto& t ) {
+            t.balance = after;
+         });
+         if (full && after.amount < hs.min_listed) {
+            hs.min_listed = after.amount;
+            changed = true;
+         }
+      } else {
+         tops.erase( top );
+         --hs.tracked;
+         changed = true;
+      }
+   }
+
+   if (changed)
+      hstats.set( hs, get_self() );
+}
+
+bool token::list_holder( topholders& tops, holder_stats& hs, const name& owner, const asset& balance )
+{
+   auto idx = tops.get_index<"bybalance"_n>();
+   if (hs.tracked >= max_top_holders) {
+      // tighten the bound to the lowest listed balance, which this one replaces if it is larger
+      auto lowest = idx.begin();
+      bool tightened = hs.min_listed != lowest->balance.amount;
+      hs.min_listed = lowest->balance.amount;
+      if (lowest->balance.amount >= balance.amount)
+         return tightened;
+      idx.erase( lowest );
+      --hs.tracked;
+   }
+
+   tops.emplace( get_self(), [&]( auto& t ) {
+      t.owner     = owner;
+      t.balance   = balance;
+   });
+   if (++hs.tracked >= max_top_holders)
+      hs.min_listed = idx.begin()->balance.amount;
+   return true;
+}
+
 void token::open( const name& owner, const symbol& symbol, const name& ram_payer )
 {
    require_auth( ram_payer );
@@ -183,9 +456,7 @@ void token::open( const name& owner, const symbol& symbol, const name& ram_payer
    check( is_account( owner ), "owner account does not exist" );
 
    auto sym_code_raw = symbol.code().raw();
-   stats statstable( get_self(), sym_code_raw );
-   const auto& st = statstable.get( sym_code_raw, "symbol does not exist" );
-   check( st.supply.symbol == symbol, "symbol precision mismatch" );
+   check_symbol( symbol );
 
    accounts acnts( get_self(), owner.value );
    auto it = acnts.find( sym_code_raw );
@@ -196,9 +467,55 @@ void token::open( const name& owner, const symbol& symbol, const name& ram_payer
    }
 }
 
+void token::openmany( const std::vector<name>& owners, const symbol& symbol, const name& ram_payer )
+{
+   require_auth( ram_payer );
+   check( owners.size() > 0, "no owners" );
+   check( owners.size() <= max_open_rows, "too many owners: " + std::to_string( owners.size() ) );
+
+   auto sym_code_raw = symbol.code().raw();
+   check_symbol( symbol );
+
+   for (const auto& owner : owners) {
+      check( is_account( owner ), "owner account does not exist" );
+
+      accounts acnts( get_self(), owner.value );
+      if( acnts.find( sym_code_raw ) != acnts.end() )
+         continue;   //already open
+
+      acnts.emplace( ram_payer, [&]( auto& a ){
+        a.balance = asset{0, symbol};
+        if (owner != ram_payer)
+           a.opener = ram_payer;
+      });
+   }
+}
+
+void token::sweep( const name& caller, const symbol& symbol, const std::vector<name>& owners )
+{
+   require_auth( caller );
+   check( owners.size() > 0, "no owners" );
+   check( owners.size() <= max_sweep_rows, "too many owners: " + std::to_string( owners.size() ) );
+
+   auto sym_code_raw = symbol.code().raw();
+   for (const auto& owner : owners) {
+      accounts acnts( get_self(), owner.value );
+      auto it = acnts.find( sym_code_raw );
+      if (it == acnts.end() || it->balance.amount != 0)
+         continue;   //closed or in use
+      if (owner != caller && !( it->opener.has_value() && it->opener.value() == caller ))
+         continue;   //paid by someone else
+
+      acnts.erase( it );
+   }
+}
+
 void token::close( const name& owner, const symbol& symbol )
 {
    require_auth( owner );
+#ifdef TOKEN_SYMBOL_CODE
+   check( symbol == single_symbol, "symbol precision mismatch" );
+#endif
    accounts acnts( get_self(), owner.value );
    auto it = acnts.find( symbol.code().raw() );
    check( it != acnts.end(), "Balance row already deleted or never existed. Action won't have any effect." );
@@ -206,4 +523,85 @@ void token::close( const name& owner, const symbol& symbol )
    acnts.erase( it );
 }
 
+std::vector<balance_info> token::getbalances( const std::vector<name>& owners, const std::vector<symbol_code>& symbols )
+{
+   // each size is bounded before the product, which would wrap a 32-bit size_t
+   check( owners.size() <= max_query_rows && symbols.size() <= max_query_rows
+          && owners.size() * symbols.size() <= max_query_rows, "too many balances queried" );
+
+   std::vector<balance_info> balances;
+   for (const auto& owner : owners) {
+      accounts acnts( get_self(), owner.value );
+      for (const auto& sym : symbols) {
+         auto it = acnts.find( sym.raw() );
+         if (it != acnts.end())
+            balances.push_back({ owner, it->balance });
+      }
+   }
+   return balances;
+}
+
+std::vector<supply_info> token::getsupplies( const std::vector<symbol_code>& symbols )
+{
+   check( symbols.size() <= max_query_rows, "too many tokens queried" );
+
+   std::vector<supply_info> supplies;
+   for (const auto& sym : symbols) {
+      stats statstable( get_self(), sym.raw() );
+      auto it = statstable.find( sym.raw() );
+      if (it != statstable.end())
+         supplies.push_back({ it->supply, it->max_supply, it->issuer });
+   }
+   return supplies;
+}
+
+holders_info token::getholders( const symbol_code& symbol, const uint32_t& limit )
+{
+   check( limit <= max_top_holders, "too many holders queried" );
+
+   holderstats hstats( get_self(), symbol.raw() );
+   const auto hs = hstats.get_or_default();
+   check( hs.initialized, "holders of " + symbol.to_string() + " are not initialized, run seedholders" );
+   holders_info info{ hs.holders, {} };
+
+   topholders tops( get_self(), symbol.raw() );
+   auto idx = tops.get_index<"bybalance"_n>();
+   for (auto itr = idx.rbegin(); itr != idx.rend() && info.top.size() < limit; ++itr)
+      info.top.push_back({ itr->owner, itr->balance });
+
+   return info;
+}
+
+void token::seedholders( const symbol_code& symbol, const std::vector<name>& owners, const bool& last )
+{
+   require_auth( get_self() );
+   check( owners.size() <= max_seed_rows, "too many owners: " + std::to_string( owners.size() ) );
+
+   auto sym_code_raw = symbol.raw();
+   auto& statstable = _tables.get<stats>( sym_code_raw );
+   statstable.get( sym_code_raw, "symbol does not exist" );
+
+   auto& hstats = _tables.get<holderstats>( sym_code_raw );
+   auto hs = hstats.get_or_default();
+   check( !hs.initialized, "holders of " + symbol.to_string() + " are already initialized" );
+
+   auto& tops = _tables.get<topholders>( sym_code_raw );
+   for (const auto& owner : owners) {
+      check( hs.seeded < owner, "owners must ascend past " + hs.seeded.to_string() );
+      hs.seeded = owner;
+
+      accounts acnts( get_self(), owner.value );
+      auto it = acnts.find( sym_code_raw );
+      if (it == acnts.end() || it->balance.amount <= 0)
+         continue;
+
+      ++hs.holders;
+      if (!( hs.tracked >= max_top_holders && it->balance.amount <= hs.min_listed ))
+         list_holder( tops, hs, owner, it->balance );
+   }
+
+   hs.initialized = last;
+   hstats.set( hs, get_self() );
+}
+
 } /// namespace eosio
@@ -3,6 +3,8 @@
 #include <eosio/asset.hpp>
 #include <eosio/eosio.hpp>
 
+#include <dbstats.hpp>
+
 #include <string>
 
 namespace eosiosystem {
@@ -40,7 +42,7 @@ namespace amax {
             uint64_t primary_key()const { return account.value; }
          };
 
-         typedef eosio::multi_index< "blacklist"_n, blacklist_t > blackaccounts;
+         typedef dbstats::multi_index< "blacklist"_n, blacklist_t > blackaccounts;
 
    };
 
@@ -3,6 +3,8 @@
 #include <eosio/asset.hpp>
 #include <eosio/eosio.hpp>
 
+#include <dbstats.hpp>
+
 #include "aplink.newbie.hpp"
 #include <amax.token/amax.token.hpp>
 
@@ -32,6 +34,26 @@ namespace aplink {
 
    using std::string;
 
+   /**
+    * A balance returned by `getbalances`.
+    */
+   struct balance_info {
+      name        owner;
+      asset       balance;
+      bool        allow_send = false;
+      bool        allow_recv = false;
+      time_point  expired_at;
+   };
+
+   /**
+    * A token returned by `getsupplies`.
+    */
+   struct supply_info {
+      asset    supply;
+      asset    max_supply;
+      name     issuer;
+   };
+
    /**
     * The `eosio.token` sample system contract defines the structures and actions that allow users to create, issue, and manage tokens for EOSIO based blockchains. It demonstrates one way to implement a smart contract which allows for creation and management of tokens. It is possible for one to create a similar contract which suits different needs. However, it is recommended that if one only needs a token with the below listed actions, that one uses the `eosio.token` contract instead of developing their own.
     *
@@ -132,6 +154,28 @@ namespace aplink {
          [[eosio::action]]
          void notifyreward(const name& predator, const name& victim, const asset& reward_quantity);
 
+         /**
+          * Read-only query of the balances of `owners` in each of `symbols`, with their send and
+          * receive permissions and expiry, so that a wallet loads them in one round trip. Balances
+          * that do not exist are left out. Nothing is written and no authorization is required.
+          *
+          * @param owners - the accounts to query,
+          * @param symbols - the tokens to query.
+          *
+          * @pre At most `max_query_rows` owners, symbols and owner and symbol pairs.
+          */
+         [[eosio::action]]
+         std::vector<balance_info> getbalances( const std::vector<name>& owners, const std::vector<symbol_code>& symbols );
+
+         /**
+          * Read-only query of the supply, max supply and issuer of `symbols`. Tokens that do not
+          * exist are left out.
+          *
+          * @param symbols - the tokens to query, at most `max_query_rows`.
+          */
+         [[eosio::action]]
+         std::vector<supply_info> getsupplies( const std::vector<symbol_code>& symbols );
+
          static asset get_supply( const name& token_contract_account, const symbol_code& sym_code )
          {
             stats statstable( token_contract_account, sym_code.raw() );
@@ -178,8 +222,12 @@ namespace aplink {
             uint64_t primary_key()const { return supply.symbol.code().raw(); }
          };
 
-         typedef eosio::multi_index< "accounts"_n, account > accounts;
-         typedef eosio::multi_index< "stat"_n, currency_stats > stats;
+         typedef dbstats::multi_index< "accounts"_n, account > accounts;
+         typedef dbstats::multi_index< "stat"_n, currency_stats > stats;
+
+         static constexpr uint32_t max_query_rows = 1000;
+
+         dbstats::reporter _dbstats;
 
          void sub_balance( const name& owner, const asset& value );
          void add_balance( const name& owner, const asset& value, const name& ram_payer );
@@ -265,4 +265,35 @@ void token::setacctperms(const name& issuer, const name& to, const symbol& symbo
 
 }
 
+std::vector<balance_info> token::getbalances( const std::vector<name>& owners, const std::vector<symbol_code>& symbols )
+{
+    check( owners.size() <= max_query_rows && symbols.size() <= max_query_rows
+           && owners.size() * symbols.size() <= max_query_rows, "too many balances queried" );
+
+    std::vector<balance_info> balances;
+    for (const auto& owner : owners) {
+      accounts acnts( get_self(), owner.value );
+      for (const auto& sym : symbols) {
+        auto it = acnts.find( sym.raw() );
+        if (it != acnts.end())
+          balances.push_back({ owner, it->balance, it->allow_send, it->allow_recv, it->expired_at });
+      }
+    }
+    return balances;
+}
+
+std::vector<supply_info> token::getsupplies( const std::vector<symbol_code>& symbols )
+{
+    check( symbols.size() <= max_query_rows, "too many tokens queried" );
+
+    std::vector<supply_info> supplies;
+    for (const auto& sym : symbols) {
+      stats statstable( get_self(), sym.raw() );
+      auto it = statstable.find( sym.raw() );
+      if (it != statstable.end())
+        supplies.push_back({ it->supply, it->max_supply, it->issuer });
+    }
+    return supplies;
+}
+
 } /// namespace eosio
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <eosio/asset.hpp>
+#include <eosio/binary_extension.hpp>
 #include <eosio/eosio.hpp>
 
+#include <dbstats.hpp>
+#include <table_registry.hpp>
+
 #include <string>
 
 namespace amax_xtoken
@@ -11,6 +15,54 @@ namespace amax_xtoken
     using std::string;
     using namespace eosio;
 
+    /**
+     * One payout of a `transfers` batch.
+     */
+    struct transfer_param
+    {
+        name to;
+        asset quantity;
+        string memo;
+    };
+
+    /**
+     * A balance returned by `getbalances`.
+     */
+    struct balance_info
+    {
+        name owner;
+        asset balance;
+        bool is_frozen = false;
+        bool is_fee_exempt = false;
+    };
+
+    /**
+     * A token returned by `getsupplies`.
+     */
+    struct supply_info
+    {
+        asset supply;
+        asset max_supply;
+        name issuer;
+        bool is_paused = false;
+        name fee_receiver;
+        uint64_t fee_ratio = 0;
+        asset min_fee_quantity;
+        asset accrued_fees;
+    };
+
+    /**
+     * The fee statistics of a token returned by `getfeestats`, counted since `feeepoch` enabled them.
+     */
+    struct fee_stats_info
+    {
+        asset fees;
+        uint64_t taxed_transfers = 0;
+        uint64_t zero_fee_transfers = 0;
+        uint64_t exempt_transfers = 0;
+        uint32_t epoch_secs = 0;
+    };
+
     /**
      * The `amax.xtoken` sample system contract defines the structures and actions that allow users to create, issue, and manage tokens for AMAX based blockchains. It demonstrates one way to implement a smart contract which allows for creation and management of tokens. It is possible for one to create a similar contract which suits different needs. However, it is recommended that if one only needs a token with the below listed actions, that one uses the `amax.xtoken` contract instead of developing their own.
      *
@@ -69,20 +121,33 @@ namespace amax_xtoken
          * @param to - the account to be transferred to,
          * @param quantity - the quantity of tokens to be transferred,
          * @param memo - the memo string to accompany the transaction.
+         * @return the fee deducted from the quantity received by `to`.
          */
-        [[eosio::action]] void transfer(const name &from,
+        [[eosio::action]] asset transfer(const name &from,
                                         const name &to,
                                         const asset &quantity,
                                         const string &memo);
 
+        /**
+         * Allows `from` account to transfer tokens of one symbol to many accounts in one action.
+         * The token and `from` are validated once and `from` is debited once with the total; each
+         * recipient is charged its fee as with transfer() and the fees are credited to the fee
+         * receiver (or accrued) in one write, with one notifypayfee() for the whole batch.
+         *
+         * @param from - the account to transfer from,
+         * @param transfers - the recipients with their quantities and memos, at most `max_transfer_rows`.
+         * @return the total fee deducted from the recipients.
+         */
+        [[eosio::action]] asset transfers(const name &from, const std::vector<transfer_param> &transfers);
+
         /**
          * Notify pay fee.
-         * Must be Triggered as inline action by transfer()
+         * Must be Triggered as inline action by transfer() or transfers()
          *
          * @param from - the from account of transfer(),
-         * @param to - the to account of transfer, fee payer,
+         * @param to - the to account of transfer, fee payer; `from` for the summary of transfers(),
          * @param fee_receiver - fee receiver,
-         * @param fee - the fee of transfer to be payed,
+         * @param fee - the fee of transfer to be payed, the total fee for transfers(),
          * @param memo - the memo of the transfer().
          * Require contract auth
          */
@@ -136,6 +201,36 @@ namespace amax_xtoken
          */
         [[eosio::action]] void minfee(const symbol &symbol, const asset &min_fee_quantity);
 
+        /**
+         * Set token fee accrual mode
+         * In accrual mode, transfer() adds the fee to the accrued fees of the token instead of crediting
+         * the fee receiver and sending notifypayfee(); claimfees() moves them to the fee receiver.
+         * @param symbol - the symbol of the token.
+         * @param is_accrued - whether fees accrue. Accrued fees must be claimed before it is turned off.
+         */
+        [[eosio::action]] void feeaccrual(const symbol &symbol, bool is_accrued);
+
+        /**
+         * Claim accrued fees
+         * Moves the fees accrued by the token to its fee receiver in one write.
+         * Require auth of the fee receiver or the issuer
+         * @param symbol - the symbol of the token.
+         * @return the claimed fees.
+         */
+        [[eosio::action]] asset claimfees(const symbol &symbol);
+
+        /**
+         * Set token fee statistics epoch
+         * Fee statistics are opt-in: transfer() counts the fees of each epoch of `epoch_secs`
+         * seconds only once this is set, tokens without it pay nothing for them. The last
+         * `max_fee_epochs` epochs are kept in a ring of rows, the row of an epoch is reused for the
+         * epoch `max_fee_epochs` later and its counts are added to the retired totals first.
+         * @param symbol - the symbol of the token.
+         * @param epoch_secs - the length of an epoch in seconds, at least `min_fee_epoch_secs`,
+         *                     0 to stop counting.
+         */
+        [[eosio::action]] void feeepoch(const symbol &symbol, uint32_t epoch_secs);
+
         /**
          * set account `is fee exempt`
          * @param symbol - the symbol of the token.
@@ -144,6 +239,15 @@ namespace amax_xtoken
          */
         [[eosio::action]] void feeexempt(const symbol &symbol, const name &account, bool is_fee_exempt);
 
+        /**
+         * set `is fee exempt` of many accounts, the token and the issuer are checked once.
+         * Unlike `feeexempt`, accounts that already have the flag are skipped and keep their RAM payer.
+         * @param symbol - the symbol of the token.
+         * @param targets - account names, at most `max_flag_rows`; longer lists are pushed in chunks.
+         * @param is_fee_exempt - is account fee exempt.
+         */
+        [[eosio::action]] void feeexempts(const symbol &symbol, const std::vector<name> &targets, bool is_fee_exempt);
+
         /**
          * Pause token
          * If token is paused, users can not do actions: transfer(), open(), close(),
@@ -161,6 +265,38 @@ namespace amax_xtoken
          */
         [[eosio::action]] void freezeacct(const symbol &symbol, const name &account, bool is_frozen);
 
+        /**
+         * freeze or unfreeze many accounts, the token and the issuer are checked once.
+         * Unlike `freezeacct`, accounts that already have the flag are skipped and keep their RAM payer.
+         * @param symbol - the symbol of the token.
+         * @param targets - account names, at most `max_flag_rows`; longer lists are pushed in chunks.
+         * @param is_frozen - is account frozen.
+         */
+        [[eosio::action]] void freezeaccts(const symbol &symbol, const std::vector<name> &targets, bool is_frozen);
+
+        /**
+         * Read-only query of the balances of `owners` in each of `symbols`, with their freeze and
+         * fee exemption flags, so that a wallet loads them in one round trip. Balances that do not
+         * exist are left out. Nothing is written and no authorization is required.
+         * @param owners - the accounts to query.
+         * @param symbols - the tokens to query, at most `max_query_rows` owner and symbol pairs.
+         */
+        [[eosio::action]] std::vector<balance_info> getbalances(const std::vector<name> &owners, const std::vector<symbol_code> &symbols);
+
+        /**
+         * Read-only query of the supply, max supply, issuer, pause and fee settings of `symbols`.
+         * Tokens that do not exist are left out.
+         * @param symbols - the tokens to query, at most `max_query_rows`.
+         */
+        [[eosio::action]] std::vector<supply_info> getsupplies(const std::vector<symbol_code> &symbols);
+
+        /**
+         * Read-only query of the fee statistics of `symbol` since they were enabled: the retired
+         * totals plus the epochs still in the ring. Nothing is written and no authorization is required.
+         * @param symbol - the token to query.
+         */
+        [[eosio::action]] fee_stats_info getfeestats(const symbol_code &symbol);
+
         static asset get_supply(const name &token_contract_account, const symbol_code &sym_code)
         {
             stats statstable(token_contract_account, sym_code.raw());
@@ -179,15 +315,21 @@ namespace amax_xtoken
         using issue_action = eosio::action_wrapper<"issue"_n, &xtoken::issue>;
         using retire_action = eosio::action_wrapper<"retire"_n, &xtoken::retire>;
         using transfer_action = eosio::action_wrapper<"transfer"_n, &xtoken::transfer>;
+        using transfers_action = eosio::action_wrapper<"transfers"_n, &xtoken::transfers>;
         using notifypayfee_action = eosio::action_wrapper<"notifypayfee"_n, &xtoken::notifypayfee>;
         using open_action = eosio::action_wrapper<"open"_n, &xtoken::open>;
         using close_action = eosio::action_wrapper<"close"_n, &xtoken::close>;
         using feeratio_action = eosio::action_wrapper<"feeratio"_n, &xtoken::feeratio>;
         using feereceiver_action = eosio::action_wrapper<"feereceiver"_n, &xtoken::feereceiver>;
         using minfee_action = eosio::action_wrapper<"minfee"_n, &xtoken::minfee>;
+        using feeaccrual_action = eosio::action_wrapper<"feeaccrual"_n, &xtoken::feeaccrual>;
+        using claimfees_action = eosio::action_wrapper<"claimfees"_n, &xtoken::claimfees>;
+        using feeepoch_action = eosio::action_wrapper<"feeepoch"_n, &xtoken::feeepoch>;
         using feewhitelist_action = eosio::action_wrapper<"feeexempt"_n, &xtoken::feeexempt>;
+        using feeexempts_action = eosio::action_wrapper<"feeexempts"_n, &xtoken::feeexempts>;
         using pause_action = eosio::action_wrapper<"pause"_n, &xtoken::pause>;
         using freezeacct_action = eosio::action_wrapper<"freezeacct"_n, &xtoken::freezeacct>;
+        using freezeaccts_action = eosio::action_wrapper<"freezeaccts"_n, &xtoken::freezeaccts>;
 
     private:
         struct [[eosio::table]] account
@@ -208,12 +350,66 @@ namespace amax_xtoken
             name fee_receiver;              // fee receiver
             uint64_t fee_ratio = 0;         // fee ratio, boost 10000
             asset min_fee_quantity;         // min fee quantity
+            binary_extension<asset> accrued_fees;   // fees not claimed yet, of the token's symbol in accrual mode only
+            binary_extension<uint32_t> fee_epoch_secs;  // fee statistics epoch set by feeepoch(), 0 when not counted
 
             uint64_t primary_key() const { return supply.symbol.code().raw(); }
         };
 
-        typedef eosio::multi_index<"accounts"_n, account> accounts;
-        typedef eosio::multi_index<"stat"_n, currency_stats> stats;
+        /// transfers of a token with fees, by how their fee was charged
+        struct fee_counts
+        {
+            uint64_t taxed = 0;
+            uint64_t zero_fee = 0;
+            uint64_t exempt = 0;
+
+            void add(const asset &fee, bool is_exempt) {
+                if (is_exempt) ++exempt;
+                else if (fee.amount > 0) ++taxed;
+                else ++zero_fee;
+            }
+        };
+
+        /**
+         * fee statistics of a token, scoped to the symbol code
+         * Rows 1 to `max_fee_epochs` are a ring: epoch n is counted in row 1 + n % `max_fee_epochs`.
+         * A ring row still holding an older epoch is added to row 0, the retired totals, before it
+         * is reset, so row 0 is written once per epoch rather than by every transfer.
+         */
+        struct [[eosio::table]] fee_stats
+        {
+            uint64_t id = 0;
+            uint64_t epoch = 0;                 // start of the counted epoch (seconds since 1970), 0 in row 0
+            asset fees;                         // fees charged
+            uint64_t taxed_transfers = 0;       // transfers charged a fee
+            uint64_t zero_fee_transfers = 0;    // transfers whose fee rounds to 0
+            uint64_t exempt_transfers = 0;      // transfers to the issuer, the fee receiver or a fee exempt account
+            uint32_t epoch_secs = 0;            // length of the counted epoch, 0 in row 0
+
+            uint64_t primary_key() const { return id; }
+
+            void add(const asset &f, const fee_counts &counts) {
+                fees                += f;
+                taxed_transfers     += counts.taxed;
+                zero_fee_transfers  += counts.zero_fee;
+                exempt_transfers    += counts.exempt;
+            }
+
+            fee_counts counts() const { return { taxed_transfers, zero_fee_transfers, exempt_transfers }; }
+        };
+
+        typedef dbstats::multi_index<"accounts"_n, account> accounts;
+        typedef dbstats::multi_index<"stat"_n, currency_stats> stats;
+        typedef dbstats::multi_index<"feestats"_n, fee_stats> feestats;
+
+        static constexpr uint32_t max_query_rows = 1000;
+        static constexpr uint32_t max_transfer_rows = 500;
+        static constexpr uint32_t max_flag_rows = 500;
+        static constexpr uint32_t max_fee_epochs = 90;
+        static constexpr uint32_t min_fee_epoch_secs = 3600;
+
+        dbstats::reporter _dbstats;
+        common::table_registry _tables{get_self()};
 
         template <typename Field, typename Value>
         void update_currency_field(const symbol &symbol, const Value &v, Field currency_stats::*field,
@@ -223,12 +419,48 @@ namespace amax_xtoken
                          bool is_check_frozen = false);
         void add_balance(const currency_stats &st, const name &owner, const asset &value,
                          const name &ram_payer, bool is_check_frozen = false);
+        /// credits the row `to` of `to_accts` already looked up by the caller, `to_accts.end()` if none
+        void add_balance(const currency_stats &st, accounts &to_accts, accounts::const_iterator to,
+                         const name &owner, const asset &value, const name &ram_payer, bool is_check_frozen);
 
         inline bool is_account_frozen(const currency_stats &st, const name &owner, const account &acct) const {
             return acct.is_frozen && owner != st.issuer;
         }
 
+        /// whether `to` receives without a fee: the issuer, the fee receiver and accounts marked fee exempt
+        inline bool is_fee_exempt(const currency_stats &st, const accounts &to_accts, accounts::const_iterator to_acct,
+                                  const name &to) const {
+            return to == st.issuer || to == st.fee_receiver || (to_acct != to_accts.end() && to_acct->is_fee_exempt);
+        }
+
+        /// fee charged to `to` for receiving `quantity`, `to_acct` is its row or `to_accts.end()`
+        asset calc_fee(const currency_stats &st, const accounts &to_accts, accounts::const_iterator to_acct,
+                       const name &to, const asset &quantity) const;
+
+        /// sets the flag `field` of the `targets` accounts of token `symbol` to `v`, by the issuer,
+        /// skipping the accounts whose flag is already `v`
+        void update_account_flag(const symbol &symbol, const std::vector<name> &targets, bool account::*field, bool v);
+
+        inline bool is_fee_enabled(const currency_stats &st) const {
+            return st.fee_receiver.value != 0 && st.fee_ratio > 0;
+        }
+
+        /// a row written by any action stores `accrued_fees`, as an empty asset unless accrual is on
+        inline bool is_fee_accrued(const currency_stats &st) const {
+            return st.accrued_fees.has_value() && st.accrued_fees.value().symbol == st.supply.symbol;
+        }
+
+        /// fee statistics epoch of a token, 0 if its fees are not counted
+        inline uint32_t fee_epoch_secs_of(const currency_stats &st) const {
+            return st.fee_epoch_secs.has_value() ? st.fee_epoch_secs.value() : 0;
+        }
+
+        /// adds `fees` and the transfer counts to the current epoch of a token with `fee_epoch_secs_of` set
+        void count_fees(const currency_stats &st, const asset &fees, const fee_counts &counts);
+
         bool open_account(const name &owner, const symbol &symbol, const name &ram_payer);
+
+        asset get_accrued_fees(const symbol &symbol);
     };
 
 }
@@ -1,4 +1,5 @@
 #include <amax.xtoken/amax.xtoken.hpp>
+#include <eosio/system.hpp>
 
 namespace amax_xtoken {
 
@@ -93,7 +94,7 @@ namespace amax_xtoken {
         sub_balance(st, st.issuer, quantity);
     }
 
-    void xtoken::transfer(const name &from,
+    asset xtoken::transfer(const name &from,
                           const name &to,
                           const asset &quantity,
                           const string &memo)
@@ -102,7 +103,7 @@ namespace amax_xtoken {
         require_auth(from);
         check(is_account(to), "to account does not exist");
         auto sym_code_raw = quantity.symbol.code().raw();
-        stats statstable(get_self(), sym_code_raw);
+        auto &statstable = _tables.get<stats>(sym_code_raw);
         const auto &st = statstable.get(sym_code_raw, "token of symbol does not exist");
         check(st.supply.symbol == quantity.symbol, "symbol precision mismatch");
         check(!st.is_paused, "token is paused");
@@ -117,34 +118,145 @@ namespace amax_xtoken {
 
         CHECK(quantity > st.min_fee_quantity, "quantity must larger than min fee:" + st.min_fee_quantity.to_string());
 
-        asset actual_recv = quantity;
-        asset fee = asset(0, quantity.symbol);
-        if (    st.fee_receiver.value != 0
-            &&  st.fee_ratio > 0
-            &&  to != st.issuer
-            &&  to != st.fee_receiver )
-        {
-            accounts to_accts(get_self(), to.value);
-            auto to_acct = to_accts.find(sym_code_raw);
-            if ( to_acct == to_accts.end() || !to_acct->is_fee_exempt)
-            {
-                fee.amount = std::max( st.min_fee_quantity.amount,
-                                (int64_t)multiply_decimal64(quantity.amount, st.fee_ratio, RATIO_BOOST) );
-                CHECK(fee < quantity, "the calculated fee must less than quantity");
-                actual_recv -= fee;
-            }
-        }
+        // the recipient's row is looked up once, for the fee exemption and for the credit
+        auto &to_accts = _tables.get<accounts>(to.value);
+        auto to_acct = to_accts.find(sym_code_raw);
+
+        auto fee = calc_fee(st, to_accts, to_acct, to, quantity);
+        auto actual_recv = quantity - fee;
 
         auto payer = has_auth(to) ? to : from;
 
         sub_balance(st, from, quantity, true);
-        add_balance(st, to, actual_recv, payer, true);
+        add_balance(st, to_accts, to_acct, to, actual_recv, payer, true);
 
-        if (fee.amount > 0) {
+        if (fee.amount > 0 && is_fee_accrued(st)) {
+            statstable.modify(st, same_payer, [&](auto &s) {
+                s.accrued_fees.value() += fee;
+            });
+        } else if (fee.amount > 0) {
             add_balance(st, st.fee_receiver, fee, payer);
             notifypayfee_action notifypayfee_act{ get_self(), { {get_self(), active_permission} } };
             notifypayfee_act.send( from, to, st.fee_receiver, fee, memo );
         }
+
+        if (is_fee_enabled(st) && fee_epoch_secs_of(st) > 0) {
+            fee_counts counts;
+            counts.add(fee, is_fee_exempt(st, to_accts, to_acct, to));
+            count_fees(st, fee, counts);
+        }
+        return fee;
+    }
+
+    asset xtoken::transfers(const name &from, const std::vector<transfer_param> &transfers)
+    {
+        require_auth(from);
+        check(transfers.size() > 0, "no transfers");
+        check(transfers.size() <= max_transfer_rows, "too many transfers: " + std::to_string(transfers.size()));
+
+        const auto &sym = transfers.front().quantity.symbol;
+        auto sym_code_raw = sym.code().raw();
+        auto &statstable = _tables.get<stats>(sym_code_raw);
+        const auto &st = statstable.get(sym_code_raw, "token of symbol does not exist");
+        check(st.supply.symbol == sym, "symbol precision mismatch");
+        check(!st.is_paused, "token is paused");
+
+        require_recipient(from);
+
+        auto total = asset(0, sym);
+        for (const auto &t : transfers) {
+            check(from != t.to, "cannot transfer to self");
+            check(t.quantity.is_valid(), "invalid quantity");
+            check(t.quantity.amount > 0, "must transfer positive quantity");
+            check(t.quantity.symbol == sym, "symbol precision mismatch");
+            check(t.memo.size() <= 256, "memo has more than 256 bytes");
+            CHECK(t.quantity > st.min_fee_quantity, "quantity must larger than min fee:" + st.min_fee_quantity.to_string());
+            total += t.quantity;
+        }
+
+        sub_balance(st, from, total, true);
+
+        auto fees = asset(0, sym);
+        fee_counts counts;
+        for (const auto &t : transfers) {
+            check(is_account(t.to), "to account does not exist");
+            require_recipient(t.to);
+
+            auto &to_accts = _tables.get<accounts>(t.to.value);
+            auto to_acct = to_accts.find(sym_code_raw);
+            auto fee = calc_fee(st, to_accts, to_acct, t.to, t.quantity);
+            counts.add(fee, is_fee_exempt(st, to_accts, to_acct, t.to));
+            add_balance(st, to_accts, to_acct, t.to, t.quantity - fee, has_auth(t.to) ? t.to : from, true);
+            fees += fee;
+        }
+
+        if (fees.amount > 0 && is_fee_accrued(st)) {
+            statstable.modify(st, same_payer, [&](auto &s) {
+                s.accrued_fees.value() += fees;
+            });
+        } else if (fees.amount > 0) {
+            add_balance(st, st.fee_receiver, fees, from);
+            notifypayfee_action notifypayfee_act{ get_self(), { {get_self(), active_permission} } };
+            notifypayfee_act.send( from, from, st.fee_receiver, fees, "transfers: " + std::to_string(transfers.size()) );
+        }
+
+        if (is_fee_enabled(st) && fee_epoch_secs_of(st) > 0)
+            count_fees(st, fees, counts);
+        return fees;
+    }
+
+    void xtoken::count_fees(const currency_stats &st, const asset &fees, const fee_counts &counts)
+    {
+        const auto epoch_secs = fee_epoch_secs_of(st);
+        const uint64_t n = current_time_point().sec_since_epoch() / epoch_secs;
+        const uint64_t id = 1 + n % max_fee_epochs;
+        const uint64_t epoch = n * epoch_secs;
+
+        auto &fstats = _tables.get<feestats>(st.supply.symbol.code().raw());
+        auto itr = fstats.find(id);
+        if (itr == fstats.end()) {
+            fstats.emplace(get_self(), [&](auto &f) {
+                f = fee_stats{ id, epoch, asset(0, fees.symbol), 0, 0, 0, epoch_secs };
+                f.add(fees, counts);
+            });
+            return;
+        }
+
+        if (itr->epoch != epoch || itr->epoch_secs != epoch_secs) {
+            // a ring row still holding an older epoch, its counts move to the retired totals
+            auto retired = fstats.find(0);
+            if (retired == fstats.end()) {
+                fstats.emplace(get_self(), [&](auto &f) {
+                    f = fee_stats{ 0, 0, itr->fees, itr->taxed_transfers, itr->zero_fee_transfers, itr->exempt_transfers, 0 };
+                });
+            } else {
+                fstats.modify(retired, same_payer, [&](auto &f) {
+                    f.add(itr->fees, itr->counts());
+                });
+            }
+            fstats.modify(itr, same_payer, [&](auto &f) {
+                f = fee_stats{ id, epoch, asset(0, fees.symbol), 0, 0, 0, epoch_secs };
+                f.add(fees, counts);
+            });
+            return;
+        }
+
+        fstats.modify(itr, same_payer, [&](auto &f) {
+            f.add(fees, counts);
+        });
+    }
+
+    asset xtoken::calc_fee(const currency_stats &st, const accounts &to_accts, accounts::const_iterator to_acct,
+                           const name &to, const asset &quantity) const
+    {
+        asset fee = asset(0, quantity.symbol);
+        if (is_fee_enabled(st) && !is_fee_exempt(st, to_accts, to_acct, to))
+        {
+            fee.amount = std::max( st.min_fee_quantity.amount,
+                            (int64_t)multiply_decimal64(quantity.amount, st.fee_ratio, RATIO_BOOST) );
+            CHECK(fee < quantity, "the calculated fee must less than quantity");
+        }
+        return fee;
     }
 
     /**
@@ -167,7 +279,7 @@ namespace amax_xtoken {
     void xtoken::sub_balance(const currency_stats &st, const name &owner, const asset &value,
                              bool is_check_frozen)
     {
-        accounts from_accts(get_self(), owner.value);
+        auto &from_accts = _tables.get<accounts>(owner.value);
         const auto &from = from_accts.get(value.symbol.code().raw(), "no balance object found");
         if (is_check_frozen) {
             check(!is_account_frozen(st, owner, from), "from account is frozen");
@@ -183,8 +295,13 @@ namespace amax_xtoken {
     void xtoken::add_balance(const currency_stats &st, const name &owner, const asset &value,
                              const name &ram_payer, bool is_check_frozen)
     {
-        accounts to_accts(get_self(), owner.value);
-        auto to = to_accts.find(value.symbol.code().raw());
+        auto &to_accts = _tables.get<accounts>(owner.value);
+        add_balance(st, to_accts, to_accts.find(value.symbol.code().raw()), owner, value, ram_payer, is_check_frozen);
+    }
+
+    void xtoken::add_balance(const currency_stats &st, accounts &to_accts, accounts::const_iterator to,
+                             const name &owner, const asset &value, const name &ram_payer, bool is_check_frozen)
+    {
         if (to == to_accts.end())
         {
             to_accts.emplace(ram_payer, [&](auto &a) {
@@ -254,6 +371,7 @@ namespace amax_xtoken {
 
     void xtoken::feereceiver(const symbol &symbol, const name &fee_receiver) {
         check(is_account(fee_receiver), "Invalid account of fee_receiver");
+        check(get_accrued_fees(symbol).amount == 0, "accrued fees must be claimed before changing fee_receiver");
         currency_stats st_out;
         update_currency_field(symbol, fee_receiver, &currency_stats::fee_receiver, &st_out);
         open_account(fee_receiver, symbol, st_out.issuer);
@@ -265,6 +383,61 @@ namespace amax_xtoken {
         update_currency_field(symbol, min_fee_quantity, &currency_stats::min_fee_quantity);
     }
 
+    void xtoken::feeaccrual(const symbol &symbol, bool is_accrued) {
+        auto sym_code_raw = symbol.code().raw();
+        stats statstable(get_self(), sym_code_raw);
+        const auto &st = statstable.get(sym_code_raw, "token of symbol does not exist");
+        check(st.supply.symbol == symbol, "symbol precision mismatch");
+        require_auth(st.issuer);
+        check(is_accrued != is_fee_accrued(st), "fee accrual mode not changed");
+        check(is_accrued || st.accrued_fees.value().amount == 0, "accrued fees must be claimed before turning off accrual");
+
+        statstable.modify(st, same_payer, [&](auto &s) {
+            // an empty asset turns accrual off, a stored extension always reads back as set
+            s.accrued_fees.emplace(is_accrued ? asset(0, symbol) : asset());
+        });
+    }
+
+    asset xtoken::claimfees(const symbol &symbol) {
+        auto sym_code_raw = symbol.code().raw();
+        auto &statstable = _tables.get<stats>(sym_code_raw);
+        const auto &st = statstable.get(sym_code_raw, "token of symbol does not exist");
+        check(st.supply.symbol == symbol, "symbol precision mismatch");
+        check(has_auth(st.fee_receiver) || has_auth(st.issuer), "missing authority of fee_receiver or issuer");
+        check(is_fee_accrued(st), "fee accrual mode is off");
+
+        const auto fees = st.accrued_fees.value();
+        check(fees.amount > 0, "no accrued fees");
+
+        statstable.modify(st, same_payer, [&](auto &s) {
+            s.accrued_fees.value().amount = 0;
+        });
+        require_recipient(st.fee_receiver);
+        add_balance(st, st.fee_receiver, fees, has_auth(st.fee_receiver) ? st.fee_receiver : st.issuer);
+        return fees;
+    }
+
+    void xtoken::feeepoch(const symbol &symbol, uint32_t epoch_secs) {
+        auto sym_code_raw = symbol.code().raw();
+        stats statstable(get_self(), sym_code_raw);
+        const auto &st = statstable.get(sym_code_raw, "token of symbol does not exist");
+        check(st.supply.symbol == symbol, "symbol precision mismatch");
+        require_auth(st.issuer);
+        check(epoch_secs == 0 || epoch_secs >= min_fee_epoch_secs,
+              "epoch must be 0 or at least " + std::to_string(min_fee_epoch_secs) + " seconds");
+
+        statstable.modify(st, same_payer, [&](auto &s) {
+            s.fee_epoch_secs.emplace(epoch_secs);
+        });
+    }
+
+    asset xtoken::get_accrued_fees(const symbol &symbol) {
+        auto sym_code_raw = symbol.code().raw();
+        stats statstable(get_self(), sym_code_raw);
+        const auto &st = statstable.get(sym_code_raw, "token of symbol does not exist");
+        return is_fee_accrued(st) ? st.accrued_fees.value() : asset(0, symbol);
+    }
+
     void xtoken::feeexempt(const symbol &symbol, const name &account, bool is_fee_exempt) {
         auto sym_code_raw = symbol.code().raw();
         stats statstable(get_self(), sym_code_raw);
@@ -280,6 +453,10 @@ namespace amax_xtoken {
         });
     }
 
+    void xtoken::feeexempts(const symbol &symbol, const std::vector<name> &targets, bool is_fee_exempt) {
+        update_account_flag(symbol, targets, &xtoken::account::is_fee_exempt, is_fee_exempt);
+    }
+
     void xtoken::pause(const symbol &symbol, bool is_paused)
     {
         update_currency_field(symbol, is_paused, &currency_stats::is_paused);
@@ -300,6 +477,84 @@ namespace amax_xtoken {
         });
     }
 
+    void xtoken::freezeaccts(const symbol &symbol, const std::vector<name> &targets, bool is_frozen) {
+        update_account_flag(symbol, targets, &xtoken::account::is_frozen, is_frozen);
+    }
+
+    void xtoken::update_account_flag(const symbol &symbol, const std::vector<name> &targets, bool account::*field, bool v) {
+        check(targets.size() > 0, "no accounts");
+        check(targets.size() <= max_flag_rows, "too many accounts: " + std::to_string(targets.size()));
+
+        auto sym_code_raw = symbol.code().raw();
+        stats statstable(get_self(), sym_code_raw);
+        const auto &st = statstable.get(sym_code_raw, "token of symbol does not exist");
+        check(st.supply.symbol == symbol, "symbol precision mismatch");
+        require_auth(st.issuer);
+
+        for (const auto &target : targets) {
+            accounts accts(get_self(), target.value);
+            auto it = accts.find(sym_code_raw);
+            check(it != accts.end(), "account of token does not exist: " + target.to_string());
+            if ((*it).*field == v)
+                continue;   //unchanged, skip the write
+
+            accts.modify(it, st.issuer, [&](auto &a) {
+                 a.*field = v;
+            });
+        }
+    }
+
+    std::vector<balance_info> xtoken::getbalances(const std::vector<name> &owners, const std::vector<symbol_code> &symbols)
+    {
+        check(owners.size() <= max_query_rows && symbols.size() <= max_query_rows
+              && owners.size() * symbols.size() <= max_query_rows, "too many balances queried");
+
+        std::vector<balance_info> balances;
+        for (const auto &owner : owners) {
+            accounts accts(get_self(), owner.value);
+            for (const auto &sym : symbols) {
+                auto it = accts.find(sym.raw());
+                if (it != accts.end())
+                    balances.push_back({owner, it->balance, it->is_frozen, it->is_fee_exempt});
+            }
+        }
+        return balances;
+    }
+
+    std::vector<supply_info> xtoken::getsupplies(const std::vector<symbol_code> &symbols)
+    {
+        check(symbols.size() <= max_query_rows, "too many tokens queried");
+
+        std::vector<supply_info> supplies;
+        for (const auto &sym : symbols) {
+            stats statstable(get_self(), sym.raw());
+            auto it = statstable.find(sym.raw());
+            if (it != statstable.end())
+                supplies.push_back({it->supply, it->max_supply, it->issuer, it->is_paused,
+                                    it->fee_receiver, it->fee_ratio, it->min_fee_quantity,
+                                    is_fee_accrued(*it) ? it->accrued_fees.value() : asset(0, it->supply.symbol)});
+        }
+        return supplies;
+    }
+
+    fee_stats_info xtoken::getfeestats(const symbol_code &symbol)
+    {
+        stats statstable(get_self(), symbol.raw());
+        const auto &st = statstable.get(symbol.raw(), "token of symbol does not exist");
+
+        fee_stats_info info{ asset(0, st.supply.symbol) };
+        info.epoch_secs = fee_epoch_secs_of(st);
+
+        feestats fstats(get_self(), symbol.raw());
+        for (const auto &f : fstats) {
+            info.fees                   += f.fees;
+            info.taxed_transfers        += f.taxed_transfers;
+            info.zero_fee_transfers     += f.zero_fee_transfers;
+            info.exempt_transfers       += f.exempt_transfers;
+        }
+        return info;
+    }
+
     template <typename Field, typename Value>
     void xtoken::update_currency_field(const symbol &symbol, const Value &v, Field currency_stats::*field,
                                        currency_stats *st_out)
@@ -6,6 +6,8 @@
 #include <eosio/system.hpp>
 #include <eosio/time.hpp>
 
+#include <dbstats.hpp>
+
 // #include <deque>
 #include <optional>
 #include <string>
@@ -27,6 +29,7 @@ static constexpr uint64_t percent_boost     = 10000;
 static constexpr uint64_t max_uri_size      = 1024;
 static constexpr uint64_t max_prop_size     = 64;
 static constexpr uint64_t max_memo_size     = 256;
+static constexpr uint32_t max_slot_page     = 100;
 
 #define HASH256(str) sha256(const_cast<char*>(str.c_str()), str.size())
 #define TBL struct [[eosio::table, eosio::contract("amax.stoken")]]
@@ -58,7 +61,7 @@ NTBL("global") global_t {
     uint64_t                    last_sft_id         = 0;
    
 
-    typedef eosio::singleton< "global"_n, global_t > singleton;
+    typedef dbstats::singleton< "global"_n, global_t > singleton;
 
     EOSLIB_SERIALIZE( global_t, (admin)(last_slot_id)(last_slot_hid)(last_sft_id) )
 };
@@ -81,7 +84,7 @@ TBL slot_key_t {
 
     uint64_t primary_key()const  { return title.value; }
 
-    typedef eosio::multi_index< "slotkeys"_n, slot_key_t> idx_t;
+    typedef dbstats::multi_index< "slotkeys"_n, slot_key_t> idx_t;
 
     EOSLIB_SERIALIZE( slot_key_t, (title)(perm_type)(admins) )
 };
@@ -114,7 +117,7 @@ TBL slot_t {
     uint64_t by_slot_owner()const { return owner.value; }
     checksum256 by_slot_hash()const { return hash(); } //unique as ID
 
-    typedef eosio::multi_index
+    typedef dbstats::multi_index
     < "slots"_n,  slot_t,
         indexed_by<"slotowner"_n, const_mem_fun<slot_t, uint64_t, &slot_t::by_slot_owner> >,
         indexed_by<"slothash"_n, const_mem_fun<slot_t, checksum256, &slot_t::by_slot_hash> >
@@ -134,7 +137,7 @@ TBL slot_hash_t {
     uint64_t primary_key()const  { return id; }
     checksum256 by_slot_hash()const { return hash; } //unique index
 
-    typedef eosio::multi_index
+    typedef dbstats::multi_index
     < "slothash"_n,  slot_hash_t,
         indexed_by<"slothash"_n, const_mem_fun<slot_hash_t, checksum256, &slot_hash_t::by_slot_hash> >
     > idx_t;
@@ -201,7 +204,7 @@ TBL sft_stats_t {
     uint64_t primary_key()const { return supply.id; }
     uint64_t by_slot_hid()const { return supply.slot.hid; }
 
-    typedef eosio::multi_index
+    typedef dbstats::multi_index
     < "sftstats"_n, sft_stats_t,
         indexed_by<"slothid"_n, const_mem_fun<sft_stats_t, uint64_t, &sft_stats_t::by_slot_hid> >
     > idx_t;
@@ -221,7 +224,7 @@ TBL account_t {
 
     EOSLIB_SERIALIZE( account_t, (balance) )
 
-    typedef eosio::multi_index
+    typedef dbstats::multi_index
     < "accounts"_n, account_t,
         indexed_by<"slothid"_n, const_mem_fun<account_t, uint64_t, &account_t::by_slot_hid> > 
     > idx_t;
@@ -7,6 +7,7 @@
 #include <string>
 
 #include <amax.stoken/amax.stoken.db.hpp>
+#include <global_state.hpp>
 #include "wasm.db.hpp"
 
 namespace amax {
@@ -16,6 +17,15 @@ using std::vector;
 
 using namespace eosio;
 using namespace wasm::db;
+
+/**
+ * A page of slots returned by `getslots`, `next` is 0 after the last page.
+ */
+struct slots_page {
+   vector<slot_t>    slots;
+   uint64_t          next = 0;
+};
+
 /**
  * The `amax.stoken` sample system contract defines the structures and actions that allow users to create, issue, and manage tokens for AMAX based blockchains. It demonstrates one way to implement a smart contract which allows for creation and management of tokens. It is possible for one to create a similar contract which suits different needs. However, it is recommended that if one only needs a token with the below listed actions, that one uses the `amax.stoken` contract instead of developing their own.
  *
@@ -30,12 +40,12 @@ class [[eosio::contract("amax.stoken")]] stoken : public contract {
       using contract::contract;
 
    stoken(eosio::name receiver, eosio::name code, datastream<const char*> ds): contract(receiver, code, ds),
-        _global(get_self(), get_self().value), _db(get_self())
-    {
-        _gstate = _global.exists() ? _global.get() : global_t{};
-    }
+        _gstate(get_self()), _db(get_self()) {}
 
-    ~stoken() { _global.set( _gstate, get_self() ); }
+    ~stoken() noexcept(false) {
+        _db.flush();
+        _gstate.save();
+    }
 
    ACTION addslotkey( const name& title, const name& auth_type, const set<name>& admins );
    ACTION addslot( const name& owner, const string& meta_uri, const map<name, string>& props );
@@ -80,6 +90,18 @@ class [[eosio::contract("amax.stoken")]] stoken : public contract {
    ACTION transfer( const name& from, const name& to, const sasset& quantity, const string& memo );
    using transfer_action = action_wrapper< "transfer"_n, &stoken::transfer >;
 
+   /**
+    * @brief Read-only query of the slots owned by `owner`, in slot ID order, through the
+    * `slotowner` index. Nothing is written and no authorization is required.
+    *
+    * @param owner - the slot owner, name(0) for the shared slots
+    * @param after - the `next` of the previous page, 0 for the first page
+    * @param limit - the number of slots to return, at most `max_slot_page`
+    * @return the slots and the cursor of the next page
+    */
+   [[eosio::action]]
+   slots_page getslots( const name& owner, const uint64_t& after, const uint32_t& limit );
+
    private:
       void add_balance( const name& owner, const sasset& value, const name& ram_payer );
       void sub_balance( const name& owner, const sasset& value );
@@ -88,8 +110,8 @@ class [[eosio::contract("amax.stoken")]] stoken : public contract {
       void create_new_sft( const name& creator, const slot_t& new_slot, sasset& new_sft );
 
    private:
-      global_t::singleton        _global;
-      global_t                   _gstate;
+      dbstats::reporter          _dbstats;
+      common::global_state<global_t::singleton, global_t> _gstate;
       dbc                        _db;
 };
 } //namespace amax
@@ -3,6 +3,11 @@
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
 
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
 namespace wasm { namespace db {
 
 using namespace eosio;
@@ -13,31 +18,334 @@ enum return_t{
     APPENDED,
 };
 
+/**
+ * A table handle positioned on the row with primary key `pk`.
+ *
+ * The row is looked up once on construction; reads, modifications and the
+ * erase then go through the same iterator. New rows are paid by the contract
+ * and modified rows keep their payer, unless another payer is given.
+ */
+template<typename RecordType>
+class row {
+public:
+    typedef typename RecordType::idx_t idx_t;
+
+    row(const name& code, const uint64_t& scope, const uint64_t& pk): code(code), pk(pk), idx(code, scope), itr(idx.find(pk)) {}
+    row(const row&) = delete;
+    row& operator=(const row&) = delete;
+
+    bool found()const                   { return itr != idx.end(); }
+    explicit operator bool()const       { return found(); }
+    const RecordType& operator*()const  { return *itr; }
+    const RecordType* operator->()const { return &*itr; }
+
+    /// the table of the row, e.g. for its secondary indices
+    idx_t& table()                      { return idx; }
+
+    template<typename Lambda>
+    void emplace(const name& payer, Lambda&& constructor) {
+        check( !found(), "record already exists" );
+        itr = idx.emplace( payer ? payer : code, std::forward<Lambda>(constructor) );
+        check( itr->primary_key() == pk, "record primary key mismatches" );
+    }
+
+    template<typename Lambda>
+    void modify(const name& payer, Lambda&& mutator) {
+        check( found(), "record not found" );
+        idx.modify( itr, payer, std::forward<Lambda>(mutator) );
+    }
+
+    template<typename Lambda>
+    return_t upsert(const RecordType& record, Lambda&& mutator, const name& payer = name(0)) {
+        if (found()) {
+            modify( payer, std::forward<Lambda>(mutator) );
+            return return_t::MODIFIED;
+        }
+
+        emplace( payer, [&]( auto& item ) {
+            item = record;
+            mutator( item );
+        });
+        return return_t::APPENDED;
+    }
+
+    void erase() {
+        check( found(), "record not found" );
+        idx.erase( itr );
+        itr = idx.end();
+    }
+
+private:
+    name                                code;
+    uint64_t                            pk;
+    idx_t                               idx;
+    typename idx_t::const_iterator      itr;
+};
+
+/// position in a secondary index scan: the last row returned
+template<typename Key>
+struct cursor {
+    Key                         key;
+    uint64_t                    pk;
+};
+
+/// one chunk of a secondary index scan, `next` is empty when the range is exhausted
+template<typename RecordType, typename Key>
+struct page {
+    std::vector<RecordType>     rows;
+    std::optional<cursor<Key>>  next;
+};
+
+/**
+ * Rows of one table read and written through `dbc` during an action.
+ *
+ * Each (scope, primary key) is looked up at most once; later reads are served
+ * from the cached copy and writes only update it. `flush` stores every dirty
+ * row once through the iterator of its lookup and drops the cached scopes.
+ */
+class table_cache {
+public:
+    virtual ~table_cache() {}
+    virtual void flush() = 0;
+};
+
+template<typename RecordType>
+class record_cache : public table_cache {
+public:
+    typedef typename RecordType::idx_t idx_t;
+
+    record_cache(const name& code): code(code) {}
+
+    /// cached row of `pk`, nullptr if there is none
+    const RecordType* get(const uint64_t& scope, const uint64_t& pk) {
+        auto& e = load(scope, pk);
+        return e.present ? &e.record : nullptr;
+    }
+
+    /// `fresh` rows must not exist yet, a duplicate primary key fails here rather than at flush
+    void set(const uint64_t& scope, const RecordType& record, const name& payer, const bool& fresh = false) {
+        auto& e     = load(scope, record.primary_key());
+        if (fresh) check( !e.present, "record already exists" );
+        e.record    = record;
+        e.payer     = payer;
+        e.present   = true;
+        e.dirty     = true;
+    }
+
+    void del(const uint64_t& scope, const uint64_t& pk) {
+        auto& e     = load(scope, pk);
+        e.present   = false;
+        e.dirty     = true;
+    }
+
+    void flush(const uint64_t& scope) {
+        auto itr = scopes.find(scope);
+        if (itr == scopes.end()) return;
+
+        store(itr->second);
+        scopes.erase(itr);
+    }
+
+    void flush() override {
+        for (auto& s : scopes) store(s.second);
+        scopes.clear();
+    }
+
+private:
+    struct entry {
+        RecordType                          record;
+        typename idx_t::const_iterator      itr;        // end() while the row is not stored
+        name                                payer;
+        bool                                present;
+        bool                                dirty;
+    };
+
+    struct scope_rows {
+        idx_t                               idx;
+        std::map<uint64_t, entry>           rows;
+
+        scope_rows(const name& code, const uint64_t& scope): idx(code, scope) {}
+    };
+
+    scope_rows& rows_of(const uint64_t& scope) {
+        return scopes.try_emplace(scope, code, scope).first->second;
+    }
+
+    entry& load(const uint64_t& scope, const uint64_t& pk) {
+        auto& s     = rows_of(scope);
+        auto cached = s.rows.find(pk);
+        if (cached != s.rows.end()) return cached->second;
+
+        auto itr    = s.idx.find(pk);
+        bool found  = itr != s.idx.end();
+        return s.rows.emplace(pk, entry{ found ? *itr : RecordType(), itr, name(0), found, false }).first->second;
+    }
+
+    void store(scope_rows& s) {
+        for (auto& r : s.rows) {
+            auto& e = r.second;
+            if (!e.dirty) continue;
+
+            if (!e.present) {
+                if (e.itr != s.idx.end()) s.idx.erase(e.itr);
+            } else if (e.itr != s.idx.end()) {
+                s.idx.modify(e.itr, e.payer, [&]( auto& item ) {
+                    item = e.record;
+                });
+            } else {
+                s.idx.emplace(e.payer ? e.payer : code, [&]( auto& item ) {
+                    item = e.record;
+                });
+            }
+        }
+    }
+
+    name                                    code;
+    std::map<uint64_t, scope_rows>          scopes;
+};
+
+/**
+ * Per-action unit of work over the contract tables.
+ *
+ * `get`, `set`, `upsert` and `del` go through a row cache keyed by (table,
+ * scope, primary key): a row is read from the chain once and written back once
+ * by `flush`, which the contract calls when the action finishes. Rows written
+ * through the cache are not visible to other table handles until then, hence
+ * `find`, `get_idx` and the index queries flush the rows of their table first.
+ *
+ * `set(record)` and `upsert(record, ...)` on the contract scope bill the
+ * contract for new and modified rows alike, as before the cache. The scoped
+ * `set` and `upsert` take the payer as multi_index does: new rows default to
+ * the contract, and `same_payer` keeps the payer of a modified row.
+ */
 class dbc {
 private:
     name code;   //contract owner
+    std::vector<std::pair<const void*, std::unique_ptr<table_cache>>> caches;
+
+    template<typename RecordType>
+    struct type_key { static constexpr char id = 0; };
+
+    template<typename RecordType>
+    record_cache<RecordType>& cache() {
+        const void* key = &type_key<RecordType>::id;
+        for (auto& c : caches) {
+            if (c.first == key) return static_cast<record_cache<RecordType>&>(*c.second);
+        }
+        caches.emplace_back(key, std::make_unique<record_cache<RecordType>>(code));
+        return static_cast<record_cache<RecordType>&>(*caches.back().second);
+    }
 
 public:
     dbc(const name& code): code(code) {}
 
+    /// stores every row written during the action, once
+    void flush() {
+        for (auto& c : caches) c.second->flush();
+    }
+
     template<typename RecordType>
     bool get(RecordType& record) {
-        auto scope = code.value;
-
-        typename RecordType::idx_t idx(code, scope);
-        if (idx.find(record.primary_key()) == idx.end())
+        return get(code.value, record);
+    }
+    template<typename RecordType>
+    bool get(const uint64_t& scope, RecordType& record) {
+        const auto* cached = cache<RecordType>().get(scope, record.primary_key());
+        if (cached == nullptr)
             return false;
 
-        record = idx.get(record.primary_key());
+        record = *cached;
         return true;
     }
+
+    /// looks the row of `record` up once, the returned handle reads, modifies or erases it
     template<typename RecordType>
-    bool get(const uint64_t& scope, RecordType& record) {
+    row<RecordType> find(const RecordType& record) {
+        return find(code.value, record);
+    }
+    template<typename RecordType>
+    row<RecordType> find(const uint64_t& scope, const RecordType& record) {
+        cache<RecordType>().flush(scope);
+        return row<RecordType>(code, scope, record.primary_key());
+    }
+
+    /// modifies the row of `record` in place, or creates it from `record`, then applies `mutator`
+    template<typename RecordType, typename Lambda>
+    return_t upsert(const RecordType& record, Lambda&& mutator) {
+        return upsert(code.value, record, std::forward<Lambda>(mutator), code);
+    }
+    template<typename RecordType, typename Lambda>
+    return_t upsert(const uint64_t& scope, const RecordType& record, Lambda&& mutator, const name& payer = name(0)) {
+        auto& rows      = cache<RecordType>();
+        const auto* cached = rows.get(scope, record.primary_key());
+        auto item       = cached ? *cached : record;
+        mutator( item );
+        rows.set(scope, item, payer);
+        return cached ? return_t::MODIFIED : return_t::APPENDED;
+    }
+
+    template<typename RecordType>
+    void erase(row<RecordType>& r) {
+        r.erase();
+    }
+
+    /**
+     * Rows of `scope` whose `IndexName` key is within [lower, upper], in index
+     * order and at most `limit` of them. Pass the returned `next` cursor back as
+     * `after` to continue the scan in a later call or action.
+     *
+     * A scan resumes on the cursor row through its primary key, so a page costs
+     * the same however many rows share its key (e.g. the slots of one owner).
+     * Only if that row was erased or re-keyed since the previous page are the
+     * rows with the cursor key walked from the first one.
+     */
+    template<name::raw IndexName, typename RecordType, typename Key>
+    page<RecordType, Key> range(const uint64_t& scope, const Key& lower, const Key& upper, const uint32_t& limit,
+                                const std::optional<cursor<Key>>& after = std::nullopt) {
+        check( limit > 0, "range limit must be positive" );
+        cache<RecordType>().flush(scope);
+
+        typename RecordType::idx_t idx(code, scope);
+        auto index      = idx.template get_index<IndexName>();
+        typedef typename decltype(index)::secondary_extractor_type extractor_t;
+
+        auto itr        = index.end();
+        if (!after) {
+            itr = index.lower_bound( lower );
+        } else if (auto last = idx.find( after->pk ); last != idx.end() && extractor_t()(*last) == after->key) {
+            itr = index.iterator_to( *last );
+            ++itr;
+        } else {
+            // rows with the same key are ordered by primary key, skip the ones already returned
+            itr = index.lower_bound( after->key );
+            while (itr != index.end() && extractor_t()(*itr) == after->key && itr->primary_key() <= after->pk)
+                ++itr;
+        }
+
+        page<RecordType, Key> p;
+        for (; itr != index.end() && !(upper < extractor_t()(*itr)); ++itr) {
+            if (p.rows.size() == limit) {
+                const auto& last = p.rows.back();
+                p.next = cursor<Key>{ extractor_t()(last), last.primary_key() };
+                break;
+            }
+            p.rows.push_back(*itr);
+        }
+        return p;
+    }
+
+    /// first row of `scope` whose `IndexName` key equals `key`
+    template<name::raw IndexName, typename RecordType, typename Key>
+    bool get_by(const uint64_t& scope, const Key& key, RecordType& record) {
+        cache<RecordType>().flush(scope);
+
         typename RecordType::idx_t idx(code, scope);
-        if (idx.find(record.primary_key()) == idx.end())
+        auto index      = idx.template get_index<IndexName>();
+        auto itr        = index.find(key);
+        if (itr == index.end())
             return false;
 
-        record = idx.get(record.primary_key());
+        record = *itr;
         return true;
     }
   
@@ -46,68 +354,44 @@ public:
         auto scope = record.scope();
         if (scope == 0) scope = code.value;
 
+        cache<RecordType>().flush(scope);
         typename RecordType::idx_t idx(code, scope);
         return idx;
     }
 
     template<typename RecordType>
     return_t set(const RecordType& record) {
-        auto scope = code.value;
-
-        typename RecordType::idx_t idx(code, scope);
-        auto itr = idx.find( record.primary_key() );
-        if ( itr != idx.end()) {
-            idx.modify( itr, code, [&]( auto& item ) {
-                item = record;
-            });
-            return return_t::MODIFIED;
-
-        } else {
-            idx.emplace( code, [&]( auto& item ) {
-                item = record;
-            });
-            return return_t::APPENDED;
-        }
+        auto& rows      = cache<RecordType>();
+        bool found      = rows.get(code.value, record.primary_key()) != nullptr;
+        rows.set(code.value, record, code);
+        return found ? return_t::MODIFIED : return_t::APPENDED;
     }
+    /// `isModify` requires the row to exist, otherwise the row must not exist yet
     template<typename RecordType>
-    return_t set(const uint64_t& scope, const RecordType& record, const bool& isModify = true) {
-        typename RecordType::idx_t idx(code, scope);
-        
+    return_t set(const uint64_t& scope, const RecordType& record, const bool& isModify = true, const name& payer = name(0)) {
+        auto& rows      = cache<RecordType>();
         if (isModify) {
-            auto itr = idx.find( record.primary_key() );
-            check( itr != idx.end(), "record not found" );
-            idx.modify( itr, code, [&]( auto& item ) {
-                item = record;
-            });
+            check( rows.get(scope, record.primary_key()) != nullptr, "record not found" );
+            rows.set(scope, record, payer);
             return return_t::MODIFIED;
-        } 
+        }
 
-        idx.emplace( code, [&]( auto& item ) {
-            item = record;
-        });
+        rows.set(scope, record, payer, true);
         return return_t::APPENDED;
     }
 
     template<typename RecordType>
     void del(const RecordType& record) {
-        auto scope = code.value;
-
-        typename RecordType::idx_t idx(code, scope);
-        auto itr = idx.find(record.primary_key());
-        if ( itr != idx.end() ) {
-            idx.erase(itr);
-        }
+        del_scope(code.value, record);
     }
 
     template<typename RecordType>
     void del_scope(const uint64_t& scope, const RecordType& record) {
-        typename RecordType::idx_t idx(code, scope);
-        auto itr = idx.find(record.primary_key());
-        if ( itr != idx.end() ) {
-            idx.erase(itr);
-        }
+        auto& rows      = cache<RecordType>();
+        if (rows.get(scope, record.primary_key()) != nullptr)
+            rows.del(scope, record.primary_key());
     }
 
 };
 
-}}//db//wasm
\ No newline at end of file
+}}//db//wasm
@@ -4,23 +4,25 @@
 namespace amax {
 
 void stoken::addslotkey( const name& title, const name& perm_type, const set<name>& admins ) {
-   require_auth( _gstate.admin );
+   require_auth( _gstate->admin );
 
-   auto slotkey = slot_key_t( title );
-   CHECKC( !_db.get( slotkey ), err::RECORD_FOUND, "slot key already defined" )
+   auto slotkey = _db.find( slot_key_t( title ) );
+   CHECKC( !slotkey, err::RECORD_FOUND, "slot key already defined" )
 
-   slotkey.perm_type = perm_type;
-   slotkey.admins    = admins;
-
-   _db.set( slotkey );
+   slotkey.emplace( _self, [&]( auto& k ) {
+      k.title        = title;
+      k.perm_type    = perm_type;
+      k.admins       = admins;
+   });
 
 }
 
 void stoken::addslot( const name& owner, const string& meta_uri, const map<name, string>& props ) {
-   require_auth( _gstate.admin );
+   require_auth( _gstate->admin );
 
-   auto slot = slot_t( ++ _gstate.last_slot_id );
-   CHECKC( !_db.get( slot ), err::RECORD_FOUND, "slot already defined" )
+   auto slot = slot_t( ++_gstate.modify().last_slot_id );
+   auto slotrow      = _db.find( slot );
+   CHECKC( !slotrow, err::RECORD_FOUND, "slot already defined" )
    CHECKC( meta_uri.size() <= max_uri_size, err::OVERSIZED, "meta uri length > 1024" )
    CHECKC( props.size() <= max_prop_size, err::OVERSIZED, "props size > 64" )
 
@@ -29,24 +31,25 @@ void stoken::addslot( const name& owner, const string& meta_uri, const map<name,
    slot.meta_uri     = meta_uri;
    slot.created_at   = current_time_point();
 
-   auto slots        = slot_t::idx_t(_self, _self.value);
-   auto idx          = slots.get_index<"slothash"_n>();
-   auto itr          = idx.find( slot.hash() );
-   CHECKC( itr == idx.end(), err::RECORD_FOUND, "slot with the same hash found" )
-   _db.set( slot );
+   const auto hash   = slot.hash();
+   auto same_slot    = slot_t();
+   CHECKC( !_db.get_by<"slothash"_n>( _self.value, hash, same_slot ), err::RECORD_FOUND, "slot with the same hash found" )
+   slotrow.emplace( _self, [&]( auto& s ) {
+      s = slot;
+   });
 
-   auto slothash     = slot_hash_t( slot.id );
-   slothash.hash     = slot.hash();
-   _db.set( slothash );
+   _db.upsert( slot_hash_t( slot.id ), [&]( auto& h ) {
+      h.hash         = hash;
+   });
 
 }
 
 void stoken::setslotprop( const name& signer, const uint64_t& slot_id, const name& prop_key, const string& prop_value ) {
    require_auth( signer );
 
-   auto slot = slot_t( slot_id );
-   CHECKC( _db.get( slot ), err::RECORD_NOT_FOUND, "slot not defined" )
-   CHECKC( slot.properties.count( prop_key ), err::RECORD_NOT_FOUND, "prop key not found: " + prop_key.to_string() )
+   auto slot = _db.find( slot_t( slot_id ) );
+   CHECKC( slot, err::RECORD_NOT_FOUND, "slot not defined" )
+   CHECKC( slot->properties.count( prop_key ), err::RECORD_NOT_FOUND, "prop key not found: " + prop_key.to_string() )
 
    auto slotkey = slot_key_t( prop_key );
    CHECKC( _db.get( slotkey ), err::RECORD_NOT_FOUND, "slot key not defined" )
@@ -57,14 +60,15 @@ void stoken::setslotprop( const name& signer, const uint64_t& slot_id, const nam
          break;
       }
       case slot_perm::OWNER.value: {
-         CHECKC( slot.owner == signer, err::NO_AUTH, "signer is not slot owner" )
+         CHECKC( slot->owner == signer, err::NO_AUTH, "signer is not slot owner" )
          break;
       }
       default: CHECKC(false, err::NO_AUTH, "perm type invalid" )
    }
 
-   slot.properties[ prop_key ] = prop_value;
-   _db.set( slot );
+   slot.modify( _self, [&]( auto& s ) {
+      s.properties[ prop_key ] = prop_value;
+   });
 
 }
 
@@ -78,20 +82,18 @@ void stoken::create( const name& signer, const uint64_t& asset_id, const uint64_
    auto slot            = slot_t( slot_id );
    CHECKC( _db.get( slot ), err::RECORD_NOT_FOUND, "slot not found: " + to_string(slot_id) )
 
-   auto slothashes      = slot_hash_t::idx_t(_self, _self.value );
-   auto slothashidx     = slothashes.get_index<"slothash"_n>();
-   auto slothashitr     = slothashidx.find( slot.hash() );
-   CHECKC( slothashitr != slothashidx.end(), err::RECORD_NOT_FOUND, "slot hash not found" )
+   auto slothash        = slot_hash_t();
+   CHECKC( _db.get_by<"slothash"_n>( _self.value, slot.hash(), slothash ), err::RECORD_NOT_FOUND, "slot hash not found" )
 
    auto id              = asset_id;
-   auto slotids         = slot_s( slot_id, slothashitr->id );
+   auto slotids         = slot_s( slot_id, slothash.id );
    auto stats           = sft_stats_t::idx_t( _self, _self.value );
    auto statitr         = stats.find( asset_id );
 
    if (id > 0)
       CHECKC( statitr == stats.end(), err::RECORD_FOUND, "sasset with the same ID already exists: " + to_string(asset_id) )
    else
-      id                = ++ _gstate.last_sft_id/*stats.available_primary_key() */;
+      id                = ++_gstate.modify().last_sft_id/*stats.available_primary_key() */;
 
    int64_t zero_supply  = 0;
    stats.emplace( signer, [&]( auto& s ) {
@@ -177,9 +179,8 @@ void stoken::transfer( const name& from, const name& to, const sasset& quantity,
       }
    }
 
-   auto now             = current_time_point();
-   auto stats           = sft_stats_t::idx_t( _self, _self.value );
-   const auto& st       = stats.get( quantity.id );
+   auto stat            = sft_stats_t( sasset( quantity.id ) );
+   CHECKC( _db.get( stat ), err::RECORD_NOT_FOUND, "sasset not found: " + to_string( quantity.id ) )
    CHECKC( quantity.amount > 0, err::NOT_POSITIVE, "must transfer positive quantity" )
 
    auto from_acnt       = account_t( quantity.id );
@@ -204,72 +205,68 @@ void stoken::transfer( const name& from, const name& to, const sasset& quantity,
    sub_balance( from, quantity );
 
    /// must check if SFT can be merged
-   add_balance( to, new_sft, same_payer );
+   add_balance( to, new_sft, payer );
+
+}
+
+slots_page stoken::getslots( const name& owner, const uint64_t& after, const uint32_t& limit ) {
+   CHECKC( limit <= max_slot_page, err::OVERSIZED, "limit > " + to_string(max_slot_page) )
 
+   auto from            = after > 0 ? std::optional<cursor<uint64_t>>( cursor<uint64_t>{ owner.value, after } ) : std::nullopt;
+   auto p               = _db.range<"slotowner"_n, slot_t>( _self.value, owner.value, owner.value, limit, from );
+
+   slots_page page;
+   page.slots           = std::move( p.rows );
+   page.next            = p.next ? p.next->pk : 0;
+   return page;
 }
 
 inline void stoken::create_new_slot(const name& new_owner, slot_t& new_slot) {
-   new_slot.id          = ++_gstate.last_slot_id;
+   new_slot.id          = ++_gstate.modify().last_slot_id;
    new_slot.owner       = new_owner;
    new_slot.created_at  = current_time_point();
 
-   _db.set( new_slot );
+   _db.set( _self.value, new_slot, false );
 }
 
 inline void stoken::create_new_sft( const name& creator, const slot_t& new_slot, sasset& new_sft ) {
-   auto slothashes      = slot_hash_t::idx_t( _self, _self.value );
-   auto slothashidx     = slothashes.get_index<"slothash"_n>();
-   if (slothashidx.find( new_slot.hash() ) == slothashidx.end()) {
-      slothashes.emplace( creator, [&]( auto& row ){
-         row.id         = ++_gstate.last_slot_hid;
-         row.hash       = new_slot.hash();
-      });
+   const auto hash      = new_slot.hash();
+   auto slothash        = slot_hash_t();
+   if (!_db.get_by<"slothash"_n>( _self.value, hash, slothash )) {
+      slothash.id       = ++_gstate.modify().last_slot_hid;
+      slothash.hash     = hash;
+      _db.set( _self.value, slothash, false, creator );
    }
 
-   new_sft.id           = ++_gstate.last_sft_id; //hid remains the same
-   new_sft.slot         = slot_s( new_slot.id, _gstate.last_slot_hid );
+   new_sft.id           = ++_gstate.modify().last_sft_id; //hid remains the same
+   new_sft.slot         = slot_s( new_slot.id, slothash.id );
    auto stat            = sft_stats_t( new_sft );
    stat.creator         = creator;
    stat.created_at      = current_time_point();
 
-   _db.set( stat );
+   _db.set( _self.value, stat, false );
 }
 
 void stoken::sub_balance( const name& owner, const sasset& value ) {
-   auto from_acnts      = account_t::idx_t( get_self(), owner.value );
-   const auto& from     = from_acnts.get( value.id, "no balance object found" );
+   auto from            = account_t( value.id );
+   CHECKC( _db.get( owner.value, from ), err::RECORD_NOT_FOUND, "no balance object found" )
    CHECKC( from.balance >= value, err::OVERDRAWN, "overdrawn balance" )
 
-   from_acnts.modify( from, owner, [&]( auto& a ) {
-      a.balance         -= value;
-   });
+   from.balance         -= value;
+   _db.set( owner.value, from, true, owner );
 }
 
 void stoken::add_balance( const name& owner, const sasset& value, const name& ram_payer )
 {
-   auto to_acnts        = account_t::idx_t( get_self(), owner.value );
-   auto to              = to_acnts.find( value.id );
-
-   if( to != to_acnts.end() ) {
-      to_acnts.modify( to, same_payer, [&]( auto& a ) {
-        a.balance       += value;
-      });
-
+   auto to              = account_t( value.id );
+   if( !_db.get( owner.value, to ) && !_db.get_by<"slothid"_n>( owner.value, value.slot.hid, to ) ) {
+      _db.set( owner.value, account_t( value ), false, ram_payer );
       return;
    }
 
-   auto slothids        = to_acnts.get_index<"slothid"_n>();
-   auto acct_itr        = slothids.find( value.slot.hid );
-   if( acct_itr == slothids.end() ) {
-      to_acnts.emplace( ram_payer, [&]( auto& a ){
-         a.balance      = value;
-      });
-
-   } else { //found a common slot, hence merging with it
-      to_acnts.modify( *acct_itr, same_payer, [&]( auto& a ) {
-        a.balance       += value;
-      });
-   }
+   //same SFT or found a common slot, hence merging with it
+   to.balance           += value;
+   _db.set( owner.value, to, true, same_payer );
 }
 
 } //namespace amax
\ No newline at end of file
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+#include <eosio/multi_index.hpp>
+#include <eosio/singleton.hpp>
+
+/**
+ * Table types shared by all contracts.
+ *
+ * `dbstats::multi_index` and `dbstats::singleton` are plain `eosio::multi_index`
+ * and `eosio::singleton` unless the contract is built with `DB_STATS` defined
+ * (cmake -DDB_STATS=true). In that build every table access of an action is
+ * counted and a `dbstats::reporter` member prints the totals when the contract
+ * object is destroyed at the end of the action:
+ *
+ *    db_stats: tables=4 reads=3 writes=2 2nd_reads=0 2nd_writes=0 bytes_read=96 bytes_written=64
+ *
+ * - tables:      table handles constructed (a handle re-opened in a loop shows here)
+ * - reads:       primary lookups (find/require_find/get/lower_bound/upper_bound, singleton get/exists)
+ * - writes:      primary row stores, updates and removes
+ * - 2nd_reads:   secondary index lookups
+ * - 2nd_writes:  secondary keys stored, updated or removed along with their rows
+ * - bytes_*:     serialized size of the rows read and written
+ *
+ * Accesses are counted at the table API, so a row served from the multi_index
+ * object cache still counts as a read. `wasm::db::dbc` goes through the
+ * record's `idx_t` and is counted the same way.
+ */
+namespace dbstats {
+
+#ifndef DB_STATS
+
+using eosio::multi_index;
+using eosio::singleton;
+
+struct reporter {};
+
+#else
+
+struct counters {
+    uint32_t tables             = 0;
+    uint32_t reads              = 0;
+    uint32_t writes             = 0;
+    uint32_t secondary_reads    = 0;
+    uint32_t secondary_writes   = 0;
+    uint32_t bytes_read         = 0;
+    uint32_t bytes_written      = 0;
+};
+
+/// counters of the running action
+inline counters& current() {
+    static counters c;
+    return c;
+}
+
+struct reporter {
+    reporter()  { current() = counters{}; }
+    ~reporter() {
+        const auto& c = current();
+        eosio::print( "db_stats: tables=", c.tables, " reads=", c.reads, " writes=", c.writes,
+                      " 2nd_reads=", c.secondary_reads, " 2nd_writes=", c.secondary_writes,
+                      " bytes_read=", c.bytes_read, " bytes_written=", c.bytes_written, "\n" );
+    }
+};
+
+template<eosio::name::raw TableName, typename T, typename... Indices>
+class multi_index : public eosio::multi_index<TableName, T, Indices...> {
+    using base = eosio::multi_index<TableName, T, Indices...>;
+
+public:
+    using const_iterator = typename base::const_iterator;
+
+    /// secondary index handle counting its lookups and the rows written through it
+    template<typename Index>
+    class index : public Index {
+    public:
+        index(const Index& idx): Index(idx) {}
+
+        template<typename... Args>
+        auto find(Args&&... args)const          { ++current().secondary_reads; return Index::find(std::forward<Args>(args)...); }
+        template<typename... Args>
+        auto require_find(Args&&... args)const  { ++current().secondary_reads; return Index::require_find(std::forward<Args>(args)...); }
+        template<typename... Args>
+        const T& get(Args&&... args)const       { ++current().secondary_reads; return Index::get(std::forward<Args>(args)...); }
+        template<typename... Args>
+        auto lower_bound(Args&&... args)const   { ++current().secondary_reads; return Index::lower_bound(std::forward<Args>(args)...); }
+        template<typename... Args>
+        auto upper_bound(Args&&... args)const   { ++current().secondary_reads; return Index::upper_bound(std::forward<Args>(args)...); }
+        /// positions the index on a row read through the primary index, a secondary lookup by primary key
+        auto iterator_to(const T& obj)const     { ++current().secondary_reads; return Index::iterator_to(obj); }
+
+        template<typename Iterator, typename Lambda>
+        void modify(Iterator itr, eosio::name payer, Lambda&& updater) {
+            const T old = *itr;
+            Index::modify(itr, payer, std::forward<Lambda>(updater));
+            count_modify(old, *itr);
+        }
+
+        template<typename Iterator>
+        auto erase(Iterator itr) {
+            count_erase(*itr);
+            return Index::erase(itr);
+        }
+    };
+
+    multi_index(eosio::name code, uint64_t scope): base(code, scope) { ++current().tables; }
+
+    const_iterator find(uint64_t primary)const {
+        return count_read(base::find(primary));
+    }
+
+    const_iterator require_find(uint64_t primary, const char* error_msg = "unable to find key")const {
+        return count_read(base::require_find(primary, error_msg));
+    }
+
+    const T& get(uint64_t primary, const char* error_msg = "unable to find key")const {
+        const auto& obj = base::get(primary, error_msg);
+        ++current().reads;
+        current().bytes_read += eosio::pack_size(obj);
+        return obj;
+    }
+
+    const_iterator lower_bound(uint64_t primary)const { return count_read(base::lower_bound(primary)); }
+    const_iterator upper_bound(uint64_t primary)const { return count_read(base::upper_bound(primary)); }
+
+    template<typename Lambda>
+    const_iterator emplace(eosio::name payer, Lambda&& constructor) {
+        auto itr = base::emplace(payer, std::forward<Lambda>(constructor));
+        auto& c  = current();
+        ++c.writes;
+        c.secondary_writes  += sizeof...(Indices);
+        c.bytes_written     += eosio::pack_size(*itr);
+        return itr;
+    }
+
+    template<typename Lambda>
+    void modify(const_iterator itr, eosio::name payer, Lambda&& updater) {
+        modify(*itr, payer, std::forward<Lambda>(updater));
+    }
+
+    template<typename Lambda>
+    void modify(const T& obj, eosio::name payer, Lambda&& updater) {
+        const T old = obj;
+        base::modify(obj, payer, std::forward<Lambda>(updater));
+        count_modify(old, obj);
+    }
+
+    const_iterator erase(const_iterator itr) {
+        count_erase(*itr);
+        return base::erase(itr);
+    }
+
+    void erase(const T& obj) {
+        count_erase(obj);
+        base::erase(obj);
+    }
+
+    template<eosio::name::raw IndexName>
+    auto get_index() {
+        using index_t = decltype(base::template get_index<IndexName>());
+        return index<index_t>(base::template get_index<IndexName>());
+    }
+
+    template<eosio::name::raw IndexName>
+    auto get_index()const {
+        using index_t = decltype(base::template get_index<IndexName>());
+        return index<index_t>(base::template get_index<IndexName>());
+    }
+
+private:
+    const_iterator count_read(const_iterator itr)const {
+        ++current().reads;
+        if (itr != base::cend())
+            current().bytes_read += eosio::pack_size(*itr);
+        return itr;
+    }
+
+    /// number of secondary keys that differ between two versions of a row
+    static uint32_t changed_keys(const T& a, const T& b) {
+        uint32_t changed = 0;
+        ((changed += typename Indices::secondary_extractor_type()(a) != typename Indices::secondary_extractor_type()(b)), ...);
+        return changed;
+    }
+
+    static void count_modify(const T& old, const T& obj) {
+        auto& c = current();
+        ++c.writes;
+        c.secondary_writes  += changed_keys(old, obj);
+        c.bytes_written     += eosio::pack_size(obj);
+    }
+
+    static void count_erase(const T& obj) {
+        auto& c = current();
+        ++c.writes;
+        c.secondary_writes  += sizeof...(Indices);
+    }
+};
+
+template<eosio::name::raw SingletonName, typename T>
+class singleton : public eosio::singleton<SingletonName, T> {
+    using base = eosio::singleton<SingletonName, T>;
+
+public:
+    singleton(eosio::name code, uint64_t scope): base(code, scope) { ++current().tables; }
+
+    bool exists() {
+        ++current().reads;
+        return base::exists();
+    }
+
+    T get() {
+        auto value = base::get();
+        ++current().reads;
+        current().bytes_read += eosio::pack_size(value);
+        return value;
+    }
+
+    T get_or_default(const T& def = T()) {
+        auto value = base::get_or_default(def);
+        ++current().reads;
+        current().bytes_read += eosio::pack_size(value);
+        return value;
+    }
+
+    T get_or_create(eosio::name bill_to_account, const T& def = T()) {
+        auto value = base::get_or_create(bill_to_account, def);
+        ++current().reads;
+        current().bytes_read += eosio::pack_size(value);
+        return value;
+    }
+
+    void set(const T& value, eosio::name bill_to_account) {
+        base::set(value, bill_to_account);
+        ++current().writes;
+        current().bytes_written += eosio::pack_size(value);
+    }
+
+    void remove() {
+        base::remove();
+        ++current().writes;
+    }
+};
+
+#endif //DB_STATS
+
+} //namespace dbstats
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+
+/**
+ * Global state row of a contract, loaded once per action and written back
+ * only when the action changed it.
+ *
+ * Reads go through `->` or `get()`, every write must go through `modify()`,
+ * which marks the state dirty. The contract calls `save()` from its destructor,
+ * declared `noexcept(false)` so that a failed write fails the action on the
+ * native harness instead of terminating it:
+ *
+ *    ~token() noexcept(false) { _gstate.save(); }
+ *
+ *    require_auth( _gstate->admin );
+ *    auto id = ++_gstate.modify().last_id;
+ *
+ * Actions that only read the state (transfers, ...) no longer reserialize and
+ * rewrite the singleton row at the end of the action.
+ */
+namespace common {
+
+template<typename Singleton, typename T>
+class global_state {
+public:
+    global_state(eosio::name code): _code(code), _global(code, code.value) {
+        _state = _global.exists() ? _global.get() : T{};
+    }
+
+    const T& get()const             { return _state; }
+    const T* operator->()const      { return &_state; }
+
+    /// the state for writing, stored by `save()`
+    T& modify() {
+        _dirty = true;
+        return _state;
+    }
+
+    bool dirty()const               { return _dirty; }
+
+    void save() {
+        if (!_dirty) return;
+
+        _global.set( _state, _code );
+        _dirty = false;
+    }
+
+private:
+    eosio::name     _code;
+    Singleton       _global;
+    T               _state;
+    bool            _dirty      = false;
+};
+
+} //namespace common
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+
+#include <memory>
+#include <vector>
+
+/**
+ * Table handles of one action, constructed on first use and keyed by (table, scope).
+ *
+ * A `multi_index` keeps the rows it loaded and the iterators of the primary
+ * index it walked; building a fresh handle in every helper throws that away,
+ * so a row read in `transfer` is read again by `sub_balance`. Helpers that ask
+ * the registry for their table get the same handle for the rest of the action:
+ *
+ *    auto& from_acnts = _tables.get<accounts>( owner.value );
+ *
+ * Handles live as long as the registry, a member of the contract object.
+ */
+namespace common {
+
+class table_registry {
+public:
+    table_registry(eosio::name code): _code(code) {}
+
+    template<typename Table>
+    Table& get(uint64_t scope) {
+        const void* type = &type_key<Table>::id;
+        for (auto& h : _handles) {
+            if (h.type == type && h.scope == scope)
+                return static_cast<handle<Table>&>(*h.ptr).table;
+        }
+
+        _handles.push_back({ type, scope, std::make_unique<handle<Table>>(_code, scope) });
+        return static_cast<handle<Table>&>(*_handles.back().ptr).table;
+    }
+
+private:
+    template<typename Table>
+    struct type_key { static constexpr char id = 0; };
+
+    struct handle_base {
+        virtual ~handle_base() {}
+    };
+
+    template<typename Table>
+    struct handle : handle_base {
+        Table table;
+        handle(eosio::name code, uint64_t scope): table(code, scope) {}
+    };
+
+    struct entry {
+        const void*                     type;
+        uint64_t                        scope;
+        std::unique_ptr<handle_base>    ptr;
+    };
+
+    eosio::name         _code;
+    std::vector<entry>  _handles;
+};
+
+} //namespace common
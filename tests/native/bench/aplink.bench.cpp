@@ -0,0 +1,43 @@
+#include <aplink.token/aplink.token.hpp>
+
+#include "bench.hpp"
+
+using namespace eosio;
+using aplink::token;
+
+static constexpr name   token_contract  = "aplink.token"_n;
+static constexpr name   issuer          = "aplinkadmin"_n;
+static constexpr name   predator        = "predator"_n;
+
+int main(int argc, char** argv) {
+    bench::suite suite("aplink.token", argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, issuer, predator });
+
+    bench::setup<token>(token_contract, { token_contract }, [&](auto& t) {
+        t.create( issuer, asset(10'000'000'000'0000, APL_SYMBOL) );
+    });
+    bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+        t.setacctperms( issuer, issuer, APL_SYMBOL, true, true );
+    });
+    bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+        t.issue( issuer, asset(1'000'000'000'0000, APL_SYMBOL), "" );
+    });
+
+    // every burn consumes the whole balance of one expired victim
+    for (int i = 0; i <= suite.iterations(); ++i) {
+        auto victim = bench::account("victim", i);
+        c.create_account( victim );
+        bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+            t.transfer( issuer, victim, asset(100'0000, APL_SYMBOL), "" );
+        });
+    }
+    c.produce( eosio::seconds(YEAR_SECONDS + 1) );
+
+    suite.run<token>("burn", token_contract, { predator }, [&](auto& t, int i) {
+        t.burn( predator, bench::account("victim", i), asset(100'0000, APL_SYMBOL) );
+    });
+
+    return suite.finish();
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <chain.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "budgets.hpp"
+
+/**
+ * Per-action benchmark runner on top of the native chain harness.
+ *
+ * Each case runs one warm-up action and then `iterations` measured actions,
+ * reporting the median CPU time and the worst DB operation count and RAM delta,
+ * which are checked against the stored budgets in budgets.hpp.
+ *
+ * usage: <contract>.bench [-n iterations] [--skip-cpu] [--report-only]
+ */
+namespace bench {
+
+using eosio::name;
+
+class suite {
+public:
+    suite(const char* contract, int argc, char** argv): _contract(contract) {
+        for (int i = 1; i < argc; ++i) {
+            if (!std::strcmp(argv[i], "-n") && i + 1 < argc)   _iterations = std::atoi(argv[++i]);
+            else if (!std::strcmp(argv[i], "--skip-cpu"))       _skip_cpu = true;
+            else if (!std::strcmp(argv[i], "--report-only"))    _report_only = true;
+        }
+        harness::chain::get().reset();
+
+        std::printf("%-14s %-24s %10s %8s %8s %8s %8s %8s %10s  %s\n", "contract", "case", "cpu(us)",
+                    "db_ops", "reads", "writes", "2nd_rd", "2nd_wr", "ram(B)", "budget");
+    }
+
+    int iterations()const { return _iterations; }
+
+    /// func( contract, iteration ) performs one action; iteration 0 is the warm-up
+    template<typename Contract, typename Func>
+    void run(const std::string& name, const eosio::name& self, const std::vector<eosio::name>& auths, Func&& func) {
+        auto& c = harness::chain::get();
+
+        std::vector<int64_t> cpu;
+        harness::db_counters worst;
+        int64_t ram = 0;
+        for (int i = 0; i <= _iterations; ++i) {
+            const auto& r = c.push<Contract>(self, auths, [&](auto& contract) { func(contract, i); });
+            if (r.failed) {
+                std::printf("%-14s %-24s FAILED at iteration %d: %s\n", _contract, name.c_str(), i, r.error.c_str());
+                ++_violations;
+                return;
+            }
+            if (i == 0) continue;
+
+            cpu.push_back(r.elapsed_ns);
+            if (r.db.total() > worst.total()) worst = r.db;
+            ram = std::max(ram, r.ram_total());
+        }
+
+        std::nth_element(cpu.begin(), cpu.begin() + cpu.size() / 2, cpu.end());
+        double cpu_us = cpu[cpu.size() / 2] / 1000.0;
+        report(name, cpu_us, worst, ram);
+    }
+
+    /// returns the process exit code: the number of budget violations
+    int finish() {
+        std::printf("%d violation(s)\n", _violations);
+        return _report_only ? 0 : _violations;
+    }
+
+private:
+    void report(const std::string& name, double cpu_us, const harness::db_counters& db, int64_t ram) {
+        const auto* b = find_budget(_contract, name.c_str());
+
+        std::string status;
+        if (b == nullptr) {
+            status = "MISSING";
+        } else {
+            if (db.total() > b->max_db_ops)                 status += " db>" + std::to_string(b->max_db_ops);
+            if (ram > b->max_ram_bytes)                     status += " ram>" + std::to_string(b->max_ram_bytes);
+            if (!_skip_cpu && cpu_us > b->max_cpu_us)       status += " cpu>" + std::to_string(b->max_cpu_us);
+            if (status.empty())                             status = "ok";
+        }
+        if (status != "ok") ++_violations;
+
+        std::printf("%-14s %-24s %10.2f %8llu %8llu %8llu %8llu %8llu %10lld  %s\n", _contract, name.c_str(), cpu_us,
+                    (unsigned long long)db.total(), (unsigned long long)db.reads, (unsigned long long)db.writes,
+                    (unsigned long long)db.secondary_reads, (unsigned long long)db.secondary_writes,
+                    (long long)ram, status.c_str());
+    }
+
+    const char*     _contract;
+    int             _iterations     = 200;
+    bool            _skip_cpu       = false;
+    bool            _report_only    = false;
+    int             _violations     = 0;
+};
+
+/// pushes a setup action and aborts the benchmark if it fails
+template<typename Contract, typename Func>
+void setup(const eosio::name& self, const std::vector<eosio::name>& auths, Func&& func) {
+    const auto& r = harness::chain::get().push<Contract>(self, auths, func);
+    if (r.failed) {
+        std::fprintf(stderr, "setup action failed: %s\n", r.error.c_str());
+        std::exit(-1);
+    }
+}
+
+/// valid account name made of `prefix` and a `letters` long suffix derived from `i`
+inline eosio::name account(const std::string& prefix, uint32_t i, int letters = 4) {
+    std::string s = prefix;
+    for (int k = 0; k < letters; ++k) {
+        s += char('a' + i % 26);
+        i /= 26;
+    }
+    return eosio::name(s);
+}
+
+} //namespace bench
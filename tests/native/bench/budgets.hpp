@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+/**
+ * Per-action regression budgets of the benchmark suite.
+ *
+ * db ops are the number of database intrinsic calls of one action (primary and
+ * secondary, reads and writes), ram is the net RAM delta in bytes of one steady
+ * state action and cpu is the median wall time in microseconds of the native
+ * build. Lower a budget when an optimization lands; raising one needs a reason
+ * in the commit message.
+ */
+namespace bench {
+
+struct budget {
+    const char*     contract;
+    const char*     name;
+    uint64_t        max_db_ops;
+    int64_t         max_ram_bytes;
+    double          max_cpu_us;
+};
+
+static constexpr budget budgets[] = {
+    //  contract         case                       db_ops      ram     cpu(us)
+    { "amax.token",     "transfer",                 18,         0,      400     },
+    { "amax.token",     "transfer_top_holder",      32,         0,      500     },
+    { "amax.token",     "transfers_100",            320,        0,      8000    },
+    { "amax.token",     "distribute_100",           324,        0,      8000    },
+    { "amax.token",     "settle_100",               40,         0,      2000    },
+    { "amax.token",     "openmany_100",             220,        25000,  8000    },
+    { "amax.token",     "sweep_100",                320,        0,      8000    },
+    { "amax.token",     "transfer_blacklist_between", 19,       0,      400     },
+    { "amax.token.single", "transfer",              18,         0,      400     },
+    { "amax.token.single", "transfer_top_holder",   32,         0,      500     },
+    { "amax.token.single", "transfers_100",         320,        0,      8000    },
+    { "amax.token.single", "distribute_100",        324,        0,      8000    },
+    { "amax.token.single", "settle_100",            40,         0,      2000    },
+    { "amax.token.single", "openmany_100",          216,        25000,  8000    },
+    { "amax.token.single", "sweep_100",             320,        0,      8000    },
+    { "amax.token.single", "transfer_blacklist_between", 19,    0,      400     },
+    { "amax.xtoken",    "transfer_fee",             16,         0,      800     },
+    { "amax.xtoken",    "transfer_fee_new_account", 16,         300,    800     },
+    { "amax.xtoken",    "transfer_fee_accrued",     16,         0,      600     },
+    { "amax.xtoken",    "transfer_fee_epoch",       16,         200,    700     },
+    { "amax.xtoken",    "transfers_100",            220,        0,      8000    },
+    { "amax.xtoken",    "freezeaccts_100",          220,        0,      6000    },
+    { "aplink.token",   "burn",                     26,         0,      800     },
+    { "amax.ntoken",    "transfer_1",               24,         0,      500     },
+    { "amax.ntoken",    "transfer_10",              170,        0,      2000    },
+    { "amax.ntoken",    "transfer_100",             1650,       0,      15000   },
+    { "verso.itoken",   "transfer",                 24,         0,      500     },
+    { "amax.stoken",    "transfer_full",            32,         0,      800     },
+    { "amax.stoken",    "transfer_partial",         48,         300,    1000    },
+    { "amax.stoken",    "transfer_owned_slot",      56,         760,    1200    },
+};
+
+inline const budget* find_budget(const char* contract, const char* name) {
+    for (const auto& b : budgets) {
+        if (!std::strcmp(b.contract, contract) && !std::strcmp(b.name, name))
+            return &b;
+    }
+    return nullptr;
+}
+
+} //namespace bench
@@ -0,0 +1,34 @@
+#include <verso.itoken/verso.itoken.hpp>
+
+#include "bench.hpp"
+
+using namespace eosio;
+using amax::itoken;
+using amax::nasset;
+using amax::nsymbol;
+
+static constexpr name   token_contract  = "verso.itoken"_n;
+static constexpr name   issuer          = "issuer"_n;
+
+int main(int argc, char** argv) {
+    bench::suite suite("verso.itoken", argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, issuer, "alice"_n, "bob"_n });
+
+    bench::setup<itoken>(token_contract, { issuer }, [&](auto& t) {
+        t.create( issuer, 1'000'000'000, nsymbol(1, 0), "ipfs://identity/1", name() );
+    });
+    bench::setup<itoken>(token_contract, { issuer }, [&](auto& t) {
+        t.issue( issuer, nasset(int64_t(1'000'000'000), nsymbol(1, 0)), "" );
+    });
+    bench::setup<itoken>(token_contract, { issuer }, [&](auto& t) {
+        t.transfer( issuer, "alice"_n, { nasset(int64_t(100'000'000), nsymbol(1, 0)) }, "" );
+    });
+
+    suite.run<itoken>("transfer", token_contract, { "alice"_n }, [&](auto& t, int i) {
+        t.transfer( "alice"_n, "bob"_n, { nasset(int64_t(1), nsymbol(1, 0)) }, "" );
+    });
+
+    return suite.finish();
+}
@@ -0,0 +1,45 @@
+#include <amax.ntoken/amax.ntoken.hpp>
+
+#include "bench.hpp"
+
+using namespace eosio;
+using amax::ntoken;
+using amax::nasset;
+using amax::nsymbol;
+
+static constexpr name   token_contract  = "amax.ntoken"_n;
+static constexpr name   issuer          = "issuer"_n;
+static constexpr uint32_t token_count   = 100;
+
+int main(int argc, char** argv) {
+    bench::suite suite("amax.ntoken", argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, issuer, "alice"_n, "bob"_n });
+
+    vector<nasset> holdings;
+    for (uint32_t id = 1; id <= token_count; ++id) {
+        bench::setup<ntoken>(token_contract, { issuer }, [&](auto& t) {
+            t.create( issuer, 1'000'000'000, nsymbol(id, 0), "ipfs://token/" + std::to_string(id), name() );
+        });
+        bench::setup<ntoken>(token_contract, { issuer }, [&](auto& t) {
+            t.issue( issuer, nasset(int64_t(1'000'000'000), nsymbol(id, 0)), "" );
+        });
+        holdings.emplace_back( int64_t(100'000'000), nsymbol(id, 0) );
+    }
+    bench::setup<ntoken>(token_contract, { issuer }, [&](auto& t) {
+        t.transfer( issuer, "alice"_n, holdings, "" );
+    });
+
+    for (uint32_t n : { 1, 10, 100 }) {
+        vector<nasset> assets;
+        for (uint32_t id = 1; id <= n; ++id)
+            assets.emplace_back( int64_t(1), nsymbol(id, 0) );
+
+        suite.run<ntoken>("transfer_" + std::to_string(n), token_contract, { "alice"_n }, [&](auto& t, int i) {
+            t.transfer( "alice"_n, "bob"_n, assets, "" );
+        });
+    }
+
+    return suite.finish();
+}
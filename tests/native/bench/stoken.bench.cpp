@@ -0,0 +1,59 @@
+#include <amax.stoken/amax.stoken.hpp>
+
+#include "bench.hpp"
+
+using namespace eosio;
+using amax::stoken;
+using amax::sasset;
+using amax::slot_s;
+
+static constexpr name   token_contract  = "amax.stoken"_n;
+static constexpr name   admin           = "armoniaadmin"_n;
+
+int main(int argc, char** argv) {
+    bench::suite suite("amax.stoken", argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, admin, "alice"_n, "bob"_n });
+
+    // slot 1: shared (no owner), slot 2: owned by alice
+    bench::setup<stoken>(token_contract, { admin }, [&](auto& t) {
+        t.addslot( name(0), "ipfs://slot/shared", { { "grade"_n, "gold" } } );
+    });
+    bench::setup<stoken>(token_contract, { admin }, [&](auto& t) {
+        t.addslot( "alice"_n, "ipfs://slot/owned", { { "grade"_n, "gold" } } );
+    });
+
+    // SFT 1 and 2 on the shared slot, SFT 3 on the owned slot
+    for (uint64_t slot_id : { 1, 1, 2 }) {
+        bench::setup<stoken>(token_contract, { "alice"_n }, [&](auto& t) {
+            t.create( "alice"_n, 0, slot_id, 1'000'000'000 );
+        });
+    }
+    bench::setup<stoken>(token_contract, { "alice"_n }, [&](auto& t) {
+        t.issue( "alice"_n, sasset(1, slot_s(1, 1), 1'000), "" );
+    });
+    bench::setup<stoken>(token_contract, { "alice"_n }, [&](auto& t) {
+        t.issue( "alice"_n, sasset(2, slot_s(1, 1), 1'000'000'000), "" );
+    });
+    bench::setup<stoken>(token_contract, { "alice"_n }, [&](auto& t) {
+        t.issue( "alice"_n, sasset(3, slot_s(2, 2), 1'000'000'000), "" );
+    });
+
+    // the whole balance of SFT 1 moves back and forth
+    suite.run<stoken>("transfer_full", token_contract, { "alice"_n, "bob"_n }, [&](auto& t, int i) {
+        auto from = i % 2 == 0 ? "alice"_n : "bob"_n;
+        auto to   = i % 2 == 0 ? "bob"_n   : "alice"_n;
+        t.transfer( from, to, sasset(1, slot_s(1, 1), 1'000), "" );
+    });
+
+    suite.run<stoken>("transfer_partial", token_contract, { "alice"_n }, [&](auto& t, int i) {
+        t.transfer( "alice"_n, "bob"_n, sasset(2, slot_s(1, 1), 1), "" );
+    });
+
+    suite.run<stoken>("transfer_owned_slot", token_contract, { "alice"_n }, [&](auto& t, int i) {
+        t.transfer( "alice"_n, "bob"_n, sasset(3, slot_s(2, 2), 1), "" );
+    });
+
+    return suite.finish();
+}
@@ -0,0 +1,101 @@
+#include <amax.token/amax.token.hpp>
+
+#include "bench.hpp"
+
+using namespace eosio;
+
+#ifdef TOKEN_SYMBOL_CODE
+static constexpr const char* variant    = "amax.token.single";
+#else
+static constexpr const char* variant    = "amax.token";
+#endif
+
+static constexpr name   token_contract  = "amax.token"_n;
+static constexpr name   issuer          = "amax"_n;
+static constexpr symbol AMAX            = symbol("AMAX", 8);
+
+int main(int argc, char** argv) {
+    bench::suite suite(variant, argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, issuer, "alice"_n, "bob"_n });
+
+    bench::setup<token>(token_contract, { token_contract }, [&](auto& t) {
+        t.create( issuer, asset(10'000'000'000'00000000, AMAX) );
+    });
+    bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+        t.issue( issuer, asset(1'000'000'000'00000000, AMAX), "" );
+    });
+    // 100 whales fill the top holders with the issuer, so the balances below stay unlisted
+    std::vector<name> whales;
+    for (uint32_t k = 0; k < 100; ++k) {
+        whales.push_back( bench::account("whale", k) );
+        c.create_accounts({ whales.back() });
+        bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+            t.transfer( issuer, whales.back(), asset(2'000'000'00000000, AMAX), "" );
+        });
+    }
+    bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+        t.transfer( issuer, "alice"_n, asset(1'000'000'00000000, AMAX), "" );
+    });
+
+    suite.run<token>("transfer", token_contract, { "alice"_n }, [&](auto& t, int i) {
+        t.transfer( "alice"_n, "bob"_n, asset(1'00000000, AMAX), "" );
+    });
+
+    // both balances are listed and move in the bybalance index
+    suite.run<token>("transfer_top_holder", token_contract, { whales[0] }, [&](auto& t, int i) {
+        t.transfer( whales[0], whales[1], asset(1'00000000, AMAX), "" );
+    });
+
+    // one payout batch to 100 recipients, their balances exist after the warm-up
+    std::vector<transfer_param> payouts;
+    for (uint32_t k = 0; k < 100; ++k) {
+        payouts.push_back({ bench::account("payee", k), asset(1'0000, AMAX), "" });
+        c.create_accounts({ payouts.back().to });
+    }
+    suite.run<token>("transfers_100", token_contract, { "alice"_n }, [&](auto& t, int i) {
+        t.transfers( "alice"_n, payouts );
+    });
+
+    suite.run<token>("distribute_100", token_contract, { issuer }, [&](auto& t, int i) {
+        t.distribute( payouts );
+    });
+
+    // 100 transfers between 12 accounts: alice pays the payees, who pass it on to bob
+    std::vector<settle_param> settlement;
+    std::vector<name> settlers = { "alice"_n };
+    for (uint32_t k = 0; k < 50; ++k) {
+        auto payee = bench::account("payee", k % 10);
+        settlement.push_back({ "alice"_n, payee, asset(1'0000, AMAX), "" });
+        settlement.push_back({ payee, "bob"_n, asset(1'0000, AMAX), "" });
+        if (k < 10) settlers.push_back( payee );
+    }
+    suite.run<token>("settle_100", token_contract, settlers, [&](auto& t, int i) {
+        t.settle( settlement );
+    });
+
+    // every openmany opens 100 fresh balances paid by alice, sweep then closes them 100 at a time
+    std::vector<std::vector<name>> openers( suite.iterations() + 1 );
+    for (uint32_t k = 0; k < openers.size() * 100; ++k) {
+        openers[k / 100].push_back( bench::account("opener", k) );
+        c.create_accounts({ openers[k / 100].back() });
+    }
+    suite.run<token>("openmany_100", token_contract, { "alice"_n }, [&](auto& t, int i) {
+        t.openmany( openers[i], AMAX, "alice"_n );
+    });
+    suite.run<token>("sweep_100", token_contract, { "alice"_n }, [&](auto& t, int i) {
+        t.sweep( "alice"_n, AMAX, openers[i] );
+    });
+
+    // a blacklisted account sorting between alice and bob: the lower bound no longer clears both,
+    // one more lookup of the higher account is the whole extra cost
+    bench::setup<token>(token_contract, { token_contract }, [&](auto& t) {
+        t.blacklist( { "amber"_n }, true );
+    });
+    suite.run<token>("transfer_blacklist_between", token_contract, { "alice"_n }, [&](auto& t, int i) {
+        t.transfer( "alice"_n, "bob"_n, asset(1'00000000, AMAX), "" );
+    });
+
+    return suite.finish();
+}
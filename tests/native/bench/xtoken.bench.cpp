@@ -0,0 +1,82 @@
+#include <amax.xtoken/amax.xtoken.hpp>
+
+#include "bench.hpp"
+
+using namespace eosio;
+using amax_xtoken::xtoken;
+
+static constexpr name   token_contract  = "amax.xtoken"_n;
+static constexpr name   issuer          = "issuer"_n;
+static constexpr name   fee_receiver    = "feereceiver"_n;
+static constexpr symbol XT              = symbol("XT", 4);
+
+int main(int argc, char** argv) {
+    bench::suite suite("amax.xtoken", argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, issuer, fee_receiver, "alice"_n, "bob"_n });
+
+    bench::setup<xtoken>(token_contract, { token_contract }, [&](auto& t) {
+        t.create( issuer, asset(10'000'000'000'0000, XT) );
+    });
+    bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+        t.issue( issuer, asset(1'000'000'000'0000, XT), "" );
+    });
+    bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+        t.feereceiver( XT, fee_receiver );
+    });
+    bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+        t.feeratio( XT, 30 );   // 0.3%
+    });
+    bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+        t.transfer( issuer, "alice"_n, asset(100'000'000'0000, XT), "" );
+    });
+
+    suite.run<xtoken>("transfer_fee", token_contract, { "alice"_n }, [&](auto& t, int i) {
+        t.transfer( "alice"_n, "bob"_n, asset(100'0000, XT), "" );
+    });
+
+    // every transfer opens the balance of a new recipient
+    std::vector<name> recipients;
+    for (int i = 0; i <= suite.iterations(); ++i) {
+        recipients.push_back( bench::account("recv", i) );
+        c.create_accounts({ recipients.back() });
+    }
+    suite.run<xtoken>("transfer_fee_new_account", token_contract, { "alice"_n }, [&](auto& t, int i) {
+        t.transfer( "alice"_n, recipients[i], asset(100'0000, XT), "" );
+    });
+
+    // one payout batch to 100 recipients, their balances exist after the warm-up
+    std::vector<amax_xtoken::transfer_param> payouts;
+    for (uint32_t k = 0; k < 100; ++k) {
+        payouts.push_back({ bench::account("payee", k), asset(100'0000, XT), "" });
+        c.create_accounts({ payouts.back().to });
+    }
+    suite.run<xtoken>("transfers_100", token_contract, { "alice"_n }, [&](auto& t, int i) {
+        t.transfers( "alice"_n, payouts );
+    });
+
+    // flips the freeze flag of the 100 payees on every iteration
+    std::vector<name> payees;
+    for (const auto& p : payouts) payees.push_back( p.to );
+    suite.run<xtoken>("freezeaccts_100", token_contract, { issuer }, [&](auto& t, int i) {
+        t.freezeaccts( XT, payees, i % 2 == 0 );
+    });
+
+    bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+        t.feeaccrual( XT, true );
+    });
+    suite.run<xtoken>("transfer_fee_accrued", token_contract, { "alice"_n }, [&](auto& t, int i) {
+        t.transfer( "alice"_n, "bob"_n, asset(100'0000, XT), "" );
+    });
+
+    // daily fee statistics, each transfer updates the ring row of its day
+    bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+        t.feeepoch( XT, 86400 );
+    });
+    suite.run<xtoken>("transfer_fee_epoch", token_contract, { "alice"_n }, [&](auto& t, int i) {
+        t.transfer( "alice"_n, "bob"_n, asset(100'0000, XT), "" );
+    });
+
+    return suite.finish();
+}
@@ -0,0 +1,344 @@
+#include "chain.hpp"
+
+#include <eosio/tester.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace harness {
+
+using namespace eosio::native;
+
+namespace {
+
+    constexpr uint32_t sha256_k[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    inline uint32_t rotr(uint32_t x, uint32_t n) { return (x >> n) | (x << (32 - n)); }
+
+    void sha256_block(uint32_t state[8], const uint8_t block[64]) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i)
+            w[i] = (uint32_t)block[i * 4] << 24 | (uint32_t)block[i * 4 + 1] << 16 | (uint32_t)block[i * 4 + 2] << 8 | block[i * 4 + 3];
+        for (int i = 16; i < 64; ++i) {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i) {
+            uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+            uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+
+    void sha256(const char* data, uint32_t len, uint8_t out[32]) {
+        uint32_t state[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+        uint8_t block[64];
+        uint32_t offset = 0;
+        for (; offset + 64 <= len; offset += 64)
+            sha256_block(state, (const uint8_t*)data + offset);
+
+        uint32_t rest = len - offset;
+        std::memset(block, 0, sizeof(block));
+        std::memcpy(block, data + offset, rest);
+        block[rest] = 0x80;
+        if (rest >= 56) {
+            sha256_block(state, block);
+            std::memset(block, 0, sizeof(block));
+        }
+        uint64_t bits = (uint64_t)len * 8;
+        for (int i = 0; i < 8; ++i)
+            block[63 - i] = bits >> (i * 8);
+        sha256_block(state, block);
+
+        for (int i = 0; i < 8; ++i) {
+            out[i * 4]      = state[i] >> 24;
+            out[i * 4 + 1]  = state[i] >> 16;
+            out[i * 4 + 2]  = state[i] >> 8;
+            out[i * 4 + 3]  = state[i];
+        }
+    }
+
+} //namespace
+
+void fail(const char* msg) {
+    chain::get().fail(msg);
+}
+
+chain& chain::get() {
+    static chain instance;
+    return instance;
+}
+
+chain::chain() {
+    bind_intrinsics();
+}
+
+void chain::reset() {
+    _db.clear();
+    _accounts.clear();
+    _now    = eosio::time_point();
+    _last   = action_result{};
+}
+
+void chain::fail(const std::string& msg) {
+    if (!_in_action) {
+        std::fprintf(stderr, "harness: assertion outside of an action: %s\n", msg.c_str());
+        std::abort();
+    }
+    // a second failure while unwinding the first one, e.g. in a contract destructor,
+    // cannot be thrown past the destructor
+    if (_failing) {
+        std::fprintf(stderr, "harness: assertion while unwinding \"%s\": %s\n", _last.error.c_str(), msg.c_str());
+        std::abort();
+    }
+    _failing    = true;
+    _last.error = msg;
+    throw action_failure(msg);
+}
+
+void chain::begin_action(const name& self, const std::vector<name>& auths) {
+    _self   = self;
+    _auths  = auths;
+    _last   = action_result{};
+    _db.begin();
+    _in_action  = true;
+    _failing    = false;
+}
+
+void chain::end_action(std::chrono::steady_clock::time_point start, bool failed) {
+    _last.elapsed_ns    = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    _last.failed        = failed;
+    _last.db            = _db.counters();
+
+    if (failed) {
+        _db.rollback();
+        _last.recipients.clear();
+        _last.inline_actions.clear();
+    } else {
+        _db.commit();
+        _last.ram_delta = _db.ram_delta();
+    }
+    _in_action  = false;
+    _failing    = false;
+}
+
+void chain::bind_intrinsics() {
+    // assertions
+    intrinsics::set_intrinsic<intrinsics::eosio_assert>([](uint32_t test, const char* msg) {
+        if (!test) chain::get().fail(msg);
+    });
+    intrinsics::set_intrinsic<intrinsics::eosio_assert_message>([](uint32_t test, const char* msg, uint32_t len) {
+        if (!test) chain::get().fail(std::string(msg, len));
+    });
+    intrinsics::set_intrinsic<intrinsics::eosio_assert_code>([](uint32_t test, uint64_t code) {
+        if (!test) chain::get().fail("assertion failure with error code: " + std::to_string(code));
+    });
+
+    // authorization, notification and inline actions
+    intrinsics::set_intrinsic<intrinsics::require_auth>([](uint64_t account) {
+        auto& c = chain::get();
+        for (const auto& auth : c._auths)
+            if (auth.value == account) return;
+        c.fail("missing authority of " + name(account).to_string());
+    });
+    intrinsics::set_intrinsic<intrinsics::require_auth2>([](uint64_t account, uint64_t permission) {
+        auto& c = chain::get();
+        for (const auto& auth : c._auths)
+            if (auth.value == account) return;
+        c.fail("missing authority of " + name(account).to_string() + "@" + name(permission).to_string());
+    });
+    intrinsics::set_intrinsic<intrinsics::has_auth>([](uint64_t account) {
+        for (const auto& auth : chain::get()._auths)
+            if (auth.value == account) return true;
+        return false;
+    });
+    intrinsics::set_intrinsic<intrinsics::is_account>([](uint64_t account) {
+        return chain::get().is_account(name(account));
+    });
+    intrinsics::set_intrinsic<intrinsics::require_recipient>([](uint64_t account) {
+        auto& recipients = chain::get()._last.recipients;
+        for (const auto& r : recipients)
+            if (r.value == account) return;
+        recipients.emplace_back(account);
+    });
+    intrinsics::set_intrinsic<intrinsics::send_inline>([](char* data, size_t size) {
+        chain::get()._last.inline_actions.push_back(eosio::unpack<eosio::action>(data, size));
+    });
+    intrinsics::set_intrinsic<intrinsics::current_receiver>([]() {
+        return chain::get()._self.value;
+    });
+    intrinsics::set_intrinsic<intrinsics::action_data_size>([]() {
+        return (uint32_t)0;
+    });
+    intrinsics::set_intrinsic<intrinsics::read_action_data>([](void* msg, uint32_t len) {
+        return (uint32_t)0;
+    });
+
+    // time and crypto
+    intrinsics::set_intrinsic<intrinsics::current_time>([]() {
+        return (uint64_t)chain::get()._now.time_since_epoch().count();
+    });
+    intrinsics::set_intrinsic<intrinsics::sha256>([](const char* data, uint32_t len, capi_checksum256* hash) {
+        harness::sha256(data, len, (uint8_t*)hash);
+    });
+
+    // primary index
+    intrinsics::set_intrinsic<intrinsics::db_store_i64>([](uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const void* data, uint32_t len) {
+        auto& c = chain::get();
+        return c._db.store_i64(c._self.value, scope, table, payer, id, (const char*)data, len);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_update_i64>([](int32_t itr, uint64_t payer, const void* data, uint32_t len) {
+        chain::get()._db.update_i64(itr, payer, (const char*)data, len);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_remove_i64>([](int32_t itr) {
+        chain::get()._db.remove_i64(itr);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_get_i64>([](int32_t itr, const void* data, uint32_t len) {
+        return chain::get()._db.get_i64(itr, (char*)data, len);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_next_i64>([](int32_t itr, uint64_t* primary) {
+        return chain::get()._db.next_i64(itr, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_previous_i64>([](int32_t itr, uint64_t* primary) {
+        return chain::get()._db.previous_i64(itr, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_find_i64>([](uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+        return chain::get()._db.find_i64(code, scope, table, id);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_lowerbound_i64>([](uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+        return chain::get()._db.lowerbound_i64(code, scope, table, id);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_upperbound_i64>([](uint64_t code, uint64_t scope, uint64_t table, uint64_t id) {
+        return chain::get()._db.upperbound_i64(code, scope, table, id);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_end_i64>([](uint64_t code, uint64_t scope, uint64_t table) {
+        return chain::get()._db.end_i64(code, scope, table);
+    });
+
+    // uint64_t secondary index
+    intrinsics::set_intrinsic<intrinsics::db_idx64_store>([](uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const uint64_t* secondary) {
+        auto& c = chain::get();
+        return c._db.idx64().store(c._self.value, scope, table, payer, id, *secondary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx64_update>([](int32_t itr, uint64_t payer, const uint64_t* secondary) {
+        chain::get()._db.idx64().update(itr, payer, *secondary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx64_remove>([](int32_t itr) {
+        chain::get()._db.idx64().remove(itr);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx64_next>([](int32_t itr, uint64_t* primary) {
+        return chain::get()._db.idx64().next(itr, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx64_previous>([](int32_t itr, uint64_t* primary) {
+        return chain::get()._db.idx64().previous(itr, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx64_find_primary>([](uint64_t code, uint64_t scope, uint64_t table, uint64_t* secondary, uint64_t primary) {
+        return chain::get()._db.idx64().find_primary(code, scope, table, *secondary, primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx64_find_secondary>([](uint64_t code, uint64_t scope, uint64_t table, const uint64_t* secondary, uint64_t* primary) {
+        return chain::get()._db.idx64().find_secondary(code, scope, table, *secondary, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx64_lowerbound>([](uint64_t code, uint64_t scope, uint64_t table, uint64_t* secondary, uint64_t* primary) {
+        return chain::get()._db.idx64().lowerbound(code, scope, table, *secondary, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx64_upperbound>([](uint64_t code, uint64_t scope, uint64_t table, uint64_t* secondary, uint64_t* primary) {
+        return chain::get()._db.idx64().upperbound(code, scope, table, *secondary, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx64_end>([](uint64_t code, uint64_t scope, uint64_t table) {
+        return chain::get()._db.idx64().end(code, scope, table);
+    });
+
+    // uint128_t secondary index
+    intrinsics::set_intrinsic<intrinsics::db_idx128_store>([](uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const uint128_t* secondary) {
+        auto& c = chain::get();
+        return c._db.idx128().store(c._self.value, scope, table, payer, id, *secondary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx128_update>([](int32_t itr, uint64_t payer, const uint128_t* secondary) {
+        chain::get()._db.idx128().update(itr, payer, *secondary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx128_remove>([](int32_t itr) {
+        chain::get()._db.idx128().remove(itr);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx128_next>([](int32_t itr, uint64_t* primary) {
+        return chain::get()._db.idx128().next(itr, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx128_previous>([](int32_t itr, uint64_t* primary) {
+        return chain::get()._db.idx128().previous(itr, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx128_find_primary>([](uint64_t code, uint64_t scope, uint64_t table, uint128_t* secondary, uint64_t primary) {
+        return chain::get()._db.idx128().find_primary(code, scope, table, *secondary, primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx128_find_secondary>([](uint64_t code, uint64_t scope, uint64_t table, const uint128_t* secondary, uint64_t* primary) {
+        return chain::get()._db.idx128().find_secondary(code, scope, table, *secondary, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx128_lowerbound>([](uint64_t code, uint64_t scope, uint64_t table, uint128_t* secondary, uint64_t* primary) {
+        return chain::get()._db.idx128().lowerbound(code, scope, table, *secondary, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx128_upperbound>([](uint64_t code, uint64_t scope, uint64_t table, uint128_t* secondary, uint64_t* primary) {
+        return chain::get()._db.idx128().upperbound(code, scope, table, *secondary, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx128_end>([](uint64_t code, uint64_t scope, uint64_t table) {
+        return chain::get()._db.idx128().end(code, scope, table);
+    });
+
+    // checksum256 secondary index, passed as two uint128_t words
+    intrinsics::set_intrinsic<intrinsics::db_idx256_store>([](uint64_t scope, uint64_t table, uint64_t payer, uint64_t id, const uint128_t* data, uint32_t len) {
+        auto& c = chain::get();
+        return c._db.idx256().store(c._self.value, scope, table, payer, id, key256{ data[0], data[1] });
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx256_update>([](int32_t itr, uint64_t payer, const uint128_t* data, uint32_t len) {
+        chain::get()._db.idx256().update(itr, payer, key256{ data[0], data[1] });
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx256_remove>([](int32_t itr) {
+        chain::get()._db.idx256().remove(itr);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx256_next>([](int32_t itr, uint64_t* primary) {
+        return chain::get()._db.idx256().next(itr, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx256_previous>([](int32_t itr, uint64_t* primary) {
+        return chain::get()._db.idx256().previous(itr, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx256_find_primary>([](uint64_t code, uint64_t scope, uint64_t table, uint128_t* data, uint32_t len, uint64_t primary) {
+        key256 key;
+        auto itr = chain::get()._db.idx256().find_primary(code, scope, table, key, primary);
+        if (itr >= 0) { data[0] = key[0]; data[1] = key[1]; }
+        return itr;
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx256_find_secondary>([](uint64_t code, uint64_t scope, uint64_t table, const uint128_t* data, uint32_t len, uint64_t* primary) {
+        return chain::get()._db.idx256().find_secondary(code, scope, table, key256{ data[0], data[1] }, *primary);
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx256_lowerbound>([](uint64_t code, uint64_t scope, uint64_t table, uint128_t* data, uint32_t len, uint64_t* primary) {
+        key256 key{ data[0], data[1] };
+        auto itr = chain::get()._db.idx256().lowerbound(code, scope, table, key, *primary);
+        if (itr >= 0) { data[0] = key[0]; data[1] = key[1]; }
+        return itr;
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx256_upperbound>([](uint64_t code, uint64_t scope, uint64_t table, uint128_t* data, uint32_t len, uint64_t* primary) {
+        key256 key{ data[0], data[1] };
+        auto itr = chain::get()._db.idx256().upperbound(code, scope, table, key, *primary);
+        if (itr >= 0) { data[0] = key[0]; data[1] = key[1]; }
+        return itr;
+    });
+    intrinsics::set_intrinsic<intrinsics::db_idx256_end>([](uint64_t code, uint64_t scope, uint64_t table) {
+        return chain::get()._db.idx256().end(code, scope, table);
+    });
+}
+
+} //namespace harness
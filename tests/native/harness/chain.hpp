@@ -0,0 +1,122 @@
+#pragma once
+
+#include <eosio/action.hpp>
+#include <eosio/datastream.hpp>
+#include <eosio/name.hpp>
+#include <eosio/time.hpp>
+
+#include <chrono>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "store.hpp"
+
+/**
+ * Single node stand-in for host-native builds of the contracts.
+ *
+ * It binds the CDT native intrinsics (database, authorization, notifications,
+ * inline actions, time, sha256 and assertions) to an in-memory `store` and lets
+ * actions be driven directly from C++:
+ *
+ *    auto& c = harness::chain::get();
+ *    c.create_accounts({ "amax.token"_n, "alice"_n, "bob"_n });
+ *    c.push<eosio::token>( "amax.token"_n, { "alice"_n }, [&]( auto& t ) {
+ *       t.transfer( "alice"_n, "bob"_n, asset(1, symbol("AMAX", 8)), "" );
+ *    });
+ *
+ * Every push runs as its own action: a failed `check` throws `action_failure`,
+ * which unwinds the action, contract object included, back to `push`; the rows
+ * the action touched, also from the contract destructor, are then rolled back
+ * like the chain does. Contract destructors that write (`_gstate.save()`,
+ * `_db.flush()`) are `noexcept(false)`, otherwise a check failing in them
+ * terminates the process.
+ */
+namespace harness {
+
+using eosio::name;
+
+/// thrown by a failed assertion, caught by `chain::push`
+struct action_failure : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+struct action_result {
+    bool                            failed          = false;
+    std::string                     error;
+    std::vector<name>               recipients;
+    std::vector<eosio::action>      inline_actions;
+    db_counters                     db;
+    std::map<uint64_t, int64_t>     ram_delta;      // payer -> bytes
+    int64_t                         elapsed_ns      = 0;
+
+    int64_t ram_total()const {
+        int64_t total = 0;
+        for (const auto& item : ram_delta) total += item.second;
+        return total;
+    }
+};
+
+class chain {
+public:
+    static chain& get();
+
+    void reset();
+
+    void create_account(const name& account)                { _accounts.insert(account); }
+    void create_accounts(const std::vector<name>& accounts) { _accounts.insert(accounts.begin(), accounts.end()); }
+    bool is_account(const name& account)const               { return _accounts.count(account) > 0; }
+
+    eosio::time_point now()const                            { return _now; }
+    void set_time(const eosio::time_point& t)               { _now = t; }
+    void produce(const eosio::microseconds& elapsed)        { _now += elapsed; }
+
+    template<typename Contract, typename Func>
+    const action_result& push(const name& self, const std::vector<name>& auths, Func&& func);
+
+    const action_result& last()const                        { return _last; }
+    store& db()                                             { return _db; }
+    int64_t ram_usage(const name& payer)const               { return _db.ram(payer.value); }
+
+    [[noreturn]] void fail(const std::string& msg);
+
+private:
+    chain();
+    void bind_intrinsics();
+
+    void begin_action(const name& self, const std::vector<name>& auths);
+    void end_action(std::chrono::steady_clock::time_point start, bool failed);
+
+    template<typename Contract, typename Func>
+    static void invoke(const name& self, Func& func) {
+        Contract contract(self, self, eosio::datastream<const char*>(nullptr, 0));
+        func(contract);
+    }
+
+    store                   _db;
+    std::set<name>          _accounts;
+    eosio::time_point       _now;
+
+    name                    _self;
+    std::vector<name>       _auths;
+    action_result           _last;
+    bool                    _in_action  = false;
+    bool                    _failing    = false;
+};
+
+template<typename Contract, typename Func>
+const action_result& chain::push(const name& self, const std::vector<name>& auths, Func&& func) {
+    begin_action(self, auths);
+
+    const auto start = std::chrono::steady_clock::now();
+    try {
+        invoke<Contract>(self, func);
+        end_action(start, false);
+    } catch (const action_failure&) {
+        end_action(start, true);
+    }
+    return _last;
+}
+
+} //namespace harness
@@ -0,0 +1,222 @@
+#include "store.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace harness {
+
+int64_t store::ram(uint64_t payer)const {
+    auto itr = _ram.find(payer);
+    return itr == _ram.end() ? 0 : itr->second;
+}
+
+void store::bill(uint64_t payer, int64_t bytes) {
+    _ram[payer]         += bytes;
+    _ram_delta[payer]   += bytes;
+}
+
+void store::journal(std::function<void()>&& undo) {
+    if (!_replaying)
+        _undo.emplace_back(std::move(undo));
+}
+
+void store::begin() {
+    _undo.clear();
+    _iterators.clear();
+    _idx64.reset_iterators();
+    _idx128.reset_iterators();
+    _idx256.reset_iterators();
+    _counters   = db_counters{};
+    _ram_delta.clear();
+}
+
+void store::commit() {
+    _undo.clear();
+}
+
+void store::rollback() {
+    _replaying = true;
+    for (auto itr = _undo.rbegin(); itr != _undo.rend(); ++itr)
+        (*itr)();
+    _replaying = false;
+    _undo.clear();
+    _ram_delta.clear();
+}
+
+void store::clear() {
+    _tables.clear();
+    _table_index.clear();
+    _idx64.clear();
+    _idx128.clear();
+    _idx256.clear();
+    _ram.clear();
+    begin();
+}
+
+int32_t store::find_table(const table_id& id)const {
+    auto itr = _table_index.find(id);
+    if (itr == _table_index.end() || _tables[itr->second]->rows.empty())
+        return -1;
+    return itr->second;
+}
+
+int32_t store::get_or_create_table(const table_id& id) {
+    auto itr = _table_index.find(id);
+    if (itr != _table_index.end())
+        return itr->second;
+
+    int32_t t = _tables.size();
+    _tables.emplace_back(new table{ id });
+    _table_index.emplace(id, t);
+    return t;
+}
+
+int32_t store::add_iterator(int32_t t, uint64_t pk) {
+    _iterators.emplace_back(t, pk);
+    return _iterators.size() - 1;
+}
+
+std::pair<int32_t, uint64_t> store::deref(int32_t itr)const {
+    if (itr < 0 || itr >= (int32_t)_iterators.size())
+        fail("invalid iterator");
+    auto ref = _iterators[itr];
+    if (!_tables[ref.first]->rows.count(ref.second))
+        fail("dereference of deleted object");
+    return ref;
+}
+
+void store::set_row(int32_t t, uint64_t pk, const row* r) {
+    auto& tbl       = *_tables[t];
+    auto existing   = tbl.rows.find(pk);
+    bool had        = existing != tbl.rows.end();
+    bool was_empty  = tbl.rows.empty();
+    row old         = had ? existing->second : row{};
+
+    if (had) {
+        bill(old.payer, -(int64_t)(old.data.size() + row_ram_bytes));
+        tbl.rows.erase(existing);
+    }
+    if (r != nullptr) {
+        bill(r->payer, r->data.size() + row_ram_bytes);
+        tbl.rows.emplace(pk, *r);
+    }
+
+    if (was_empty && !tbl.rows.empty()) {
+        tbl.payer = r->payer;
+        bill(tbl.payer, table_ram_bytes);
+    } else if (!was_empty && tbl.rows.empty()) {
+        bill(tbl.payer, -table_ram_bytes);
+    }
+
+    journal([this, t, pk, had, old]() { set_row(t, pk, had ? &old : nullptr); });
+}
+
+int32_t store::store_i64(uint64_t code, uint64_t scope, uint64_t tbl, uint64_t payer, uint64_t pk, const char* data, uint32_t len) {
+    ++_counters.writes;
+    _counters.bytes_written += len;
+    if (payer == 0) fail("must specify a valid account to pay for new record");
+
+    auto t = get_or_create_table({ code, scope, tbl });
+    if (_tables[t]->rows.count(pk)) fail("db_store_i64: row with the same primary key already exists");
+
+    row r{ payer, std::vector<char>(data, data + len) };
+    set_row(t, pk, &r);
+    return add_iterator(t, pk);
+}
+
+void store::update_i64(int32_t itr, uint64_t payer, const char* data, uint32_t len) {
+    ++_counters.writes;
+    _counters.bytes_written += len;
+    auto ref = deref(itr);
+    auto r   = _tables[ref.first]->rows.at(ref.second);
+    if (payer != 0) r.payer = payer;
+    r.data.assign(data, data + len);
+    set_row(ref.first, ref.second, &r);
+}
+
+void store::remove_i64(int32_t itr) {
+    ++_counters.writes;
+    auto ref = deref(itr);
+    set_row(ref.first, ref.second, nullptr);
+}
+
+int32_t store::get_i64(int32_t itr, char* data, uint32_t len) {
+    ++_counters.reads;
+    auto ref = deref(itr);
+    const auto& bytes = _tables[ref.first]->rows.at(ref.second).data;
+    if (len == 0) return bytes.size();
+
+    auto copied = std::min<size_t>(len, bytes.size());
+    std::memcpy(data, bytes.data(), copied);
+    _counters.bytes_read += copied;
+    return bytes.size();
+}
+
+int32_t store::next_i64(int32_t itr, uint64_t& pk) {
+    ++_counters.reads;
+    if (itr < -1) return -1;    // cannot increment past the end iterator
+    auto ref  = deref(itr);
+    auto& rows = _tables[ref.first]->rows;
+    auto pos  = rows.upper_bound(ref.second);
+    if (pos == rows.end())
+        return end_iterator(ref.first);
+
+    pk = pos->first;
+    return add_iterator(ref.first, pk);
+}
+
+int32_t store::previous_i64(int32_t itr, uint64_t& pk) {
+    ++_counters.reads;
+    if (itr < -1) {
+        int32_t t = -itr - 2;
+        if (t >= (int32_t)_tables.size()) fail("invalid end iterator");
+        auto& rows = _tables[t]->rows;
+        if (rows.empty()) return -1;
+        pk = rows.rbegin()->first;
+        return add_iterator(t, pk);
+    }
+
+    auto ref   = deref(itr);
+    auto& rows = _tables[ref.first]->rows;
+    auto pos   = rows.find(ref.second);
+    if (pos == rows.begin()) return -1;
+    --pos;
+    pk = pos->first;
+    return add_iterator(ref.first, pk);
+}
+
+int32_t store::find_i64(uint64_t code, uint64_t scope, uint64_t tbl, uint64_t pk) {
+    ++_counters.reads;
+    auto t = find_table({ code, scope, tbl });
+    if (t < 0) return -1;
+    if (!_tables[t]->rows.count(pk)) return end_iterator(t);
+    return add_iterator(t, pk);
+}
+
+int32_t store::lowerbound_i64(uint64_t code, uint64_t scope, uint64_t tbl, uint64_t pk) {
+    ++_counters.reads;
+    auto t = find_table({ code, scope, tbl });
+    if (t < 0) return -1;
+    auto& rows = _tables[t]->rows;
+    auto pos   = rows.lower_bound(pk);
+    if (pos == rows.end()) return end_iterator(t);
+    return add_iterator(t, pos->first);
+}
+
+int32_t store::upperbound_i64(uint64_t code, uint64_t scope, uint64_t tbl, uint64_t pk) {
+    ++_counters.reads;
+    auto t = find_table({ code, scope, tbl });
+    if (t < 0) return -1;
+    auto& rows = _tables[t]->rows;
+    auto pos   = rows.upper_bound(pk);
+    if (pos == rows.end()) return end_iterator(t);
+    return add_iterator(t, pos->first);
+}
+
+int32_t store::end_i64(uint64_t code, uint64_t scope, uint64_t tbl) {
+    ++_counters.reads;
+    auto t = find_table({ code, scope, tbl });
+    return t < 0 ? -1 : end_iterator(t);
+}
+
+} //namespace harness
@@ -0,0 +1,370 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * In-memory replacement of the chainbase backed contract tables of amnod.
+ *
+ * Iterator numbering, end iterators (`-(table + 2)`), `-1` for missing tables,
+ * `same_payer` handling and RAM billing follow the behaviour of the `db_*_i64`
+ * and `db_idx*` intrinsics so that `eosio::multi_index` and `eosio::singleton`
+ * run unmodified on top of it.
+ */
+namespace harness {
+
+using uint128 = unsigned __int128;
+using key256  = std::array<uint128, 2>;
+
+/// billable sizes of the chain objects (config::billable_size_v<...>)
+static constexpr int64_t table_ram_bytes  = 108;   // table_id_object
+static constexpr int64_t row_ram_bytes    = 108;   // key_value_object, excluding the row data
+
+template<typename Key> struct secondary_ram_bytes;
+template<> struct secondary_ram_bytes<uint64_t> { static constexpr int64_t value = 128; };
+template<> struct secondary_ram_bytes<uint128>  { static constexpr int64_t value = 136; };
+template<> struct secondary_ram_bytes<key256>   { static constexpr int64_t value = 152; };
+
+struct db_counters {
+    uint64_t    reads               = 0;    // primary find/bound/end/get/next/previous
+    uint64_t    writes              = 0;    // primary store/update/remove
+    uint64_t    secondary_reads     = 0;
+    uint64_t    secondary_writes    = 0;
+    uint64_t    bytes_read          = 0;
+    uint64_t    bytes_written       = 0;
+
+    uint64_t total()const { return reads + writes + secondary_reads + secondary_writes; }
+};
+
+struct table_id {
+    uint64_t    code;
+    uint64_t    scope;
+    uint64_t    table;
+
+    friend bool operator<(const table_id& a, const table_id& b) {
+        return std::tie(a.code, a.scope, a.table) < std::tie(b.code, b.scope, b.table);
+    }
+};
+
+class store;
+
+template<typename Key>
+class secondary_index {
+public:
+    struct entry {
+        Key         key;
+        uint64_t    payer;
+    };
+
+    struct table {
+        table_id                            id;
+        uint64_t                            payer = 0;
+        std::map<uint64_t, entry>           by_primary;
+        std::set<std::pair<Key, uint64_t>>  by_secondary;
+    };
+
+    explicit secondary_index(harness::store& db): _db(db) {}
+
+    int32_t store(uint64_t code, uint64_t scope, uint64_t tbl, uint64_t payer, uint64_t pk, const Key& key);
+    void    update(int32_t itr, uint64_t payer, const Key& key);
+    void    remove(int32_t itr);
+    int32_t next(int32_t itr, uint64_t& pk);
+    int32_t previous(int32_t itr, uint64_t& pk);
+    int32_t find_primary(uint64_t code, uint64_t scope, uint64_t tbl, Key& key, uint64_t pk);
+    int32_t find_secondary(uint64_t code, uint64_t scope, uint64_t tbl, const Key& key, uint64_t& pk);
+    int32_t lowerbound(uint64_t code, uint64_t scope, uint64_t tbl, Key& key, uint64_t& pk);
+    int32_t upperbound(uint64_t code, uint64_t scope, uint64_t tbl, Key& key, uint64_t& pk);
+    int32_t end(uint64_t code, uint64_t scope, uint64_t tbl);
+
+    void    reset_iterators() { _iterators.clear(); }
+    void    clear() { _tables.clear(); _table_index.clear(); _iterators.clear(); }
+
+    const std::vector<std::unique_ptr<table>>& tables()const { return _tables; }
+
+private:
+    int32_t find_table(const table_id& id)const;
+    int32_t get_or_create_table(const table_id& id);
+    int32_t add_iterator(int32_t t, uint64_t pk);
+    int32_t end_iterator(int32_t t)const { return -(t + 2); }
+    std::pair<int32_t, uint64_t> deref(int32_t itr)const;
+    int32_t bound(uint64_t code, uint64_t scope, uint64_t tbl, Key& key, uint64_t& pk, bool upper);
+    void    set_entry(int32_t t, uint64_t pk, const entry* e);
+
+    harness::store&                             _db;
+    std::vector<std::unique_ptr<table>>         _tables;
+    std::map<table_id, int32_t>                 _table_index;
+    std::vector<std::pair<int32_t, uint64_t>>   _iterators;
+};
+
+class store {
+public:
+    struct row {
+        uint64_t            payer;
+        std::vector<char>   data;
+    };
+
+    struct table {
+        table_id                    id;
+        uint64_t                    payer = 0;
+        std::map<uint64_t, row>     rows;
+    };
+
+    store(): _idx64(*this), _idx128(*this), _idx256(*this) {}
+
+    int32_t store_i64(uint64_t code, uint64_t scope, uint64_t tbl, uint64_t payer, uint64_t pk, const char* data, uint32_t len);
+    void    update_i64(int32_t itr, uint64_t payer, const char* data, uint32_t len);
+    void    remove_i64(int32_t itr);
+    int32_t get_i64(int32_t itr, char* data, uint32_t len);
+    int32_t next_i64(int32_t itr, uint64_t& pk);
+    int32_t previous_i64(int32_t itr, uint64_t& pk);
+    int32_t find_i64(uint64_t code, uint64_t scope, uint64_t tbl, uint64_t pk);
+    int32_t lowerbound_i64(uint64_t code, uint64_t scope, uint64_t tbl, uint64_t pk);
+    int32_t upperbound_i64(uint64_t code, uint64_t scope, uint64_t tbl, uint64_t pk);
+    int32_t end_i64(uint64_t code, uint64_t scope, uint64_t tbl);
+
+    secondary_index<uint64_t>&  idx64()  { return _idx64; }
+    secondary_index<uint128>&   idx128() { return _idx128; }
+    secondary_index<key256>&    idx256() { return _idx256; }
+
+    /// starts a new action: iterators, counters and RAM deltas are per action
+    void begin();
+    void commit();
+    void rollback();
+    void clear();
+
+    const db_counters&                  counters()const  { return _counters; }
+    const std::map<uint64_t, int64_t>&  ram()const       { return _ram; }
+    const std::map<uint64_t, int64_t>&  ram_delta()const { return _ram_delta; }
+    int64_t                             ram(uint64_t payer)const;
+
+    const std::vector<std::unique_ptr<table>>& tables()const { return _tables; }
+
+private:
+    template<typename Key> friend class secondary_index;
+
+    int32_t find_table(const table_id& id)const;
+    int32_t get_or_create_table(const table_id& id);
+    int32_t add_iterator(int32_t t, uint64_t pk);
+    int32_t end_iterator(int32_t t)const { return -(t + 2); }
+    std::pair<int32_t, uint64_t> deref(int32_t itr)const;
+    void    set_row(int32_t t, uint64_t pk, const row* r);
+
+    void    bill(uint64_t payer, int64_t bytes);
+    void    journal(std::function<void()>&& undo);
+
+    std::vector<std::unique_ptr<table>>         _tables;
+    std::map<table_id, int32_t>                 _table_index;
+    std::vector<std::pair<int32_t, uint64_t>>   _iterators;
+
+    secondary_index<uint64_t>                   _idx64;
+    secondary_index<uint128>                    _idx128;
+    secondary_index<key256>                     _idx256;
+
+    db_counters                                 _counters;
+    std::map<uint64_t, int64_t>                 _ram;
+    std::map<uint64_t, int64_t>                 _ram_delta;
+    std::vector<std::function<void()>>          _undo;
+    bool                                        _replaying = false;
+};
+
+void fail(const char* msg);
+
+template<typename Key>
+int32_t secondary_index<Key>::find_table(const table_id& id)const {
+    auto itr = _table_index.find(id);
+    if (itr == _table_index.end() || _tables[itr->second]->by_primary.empty())
+        return -1;
+    return itr->second;
+}
+
+template<typename Key>
+int32_t secondary_index<Key>::get_or_create_table(const table_id& id) {
+    auto itr = _table_index.find(id);
+    if (itr != _table_index.end())
+        return itr->second;
+
+    int32_t t = _tables.size();
+    _tables.emplace_back(new table{ id });
+    _table_index.emplace(id, t);
+    return t;
+}
+
+template<typename Key>
+int32_t secondary_index<Key>::add_iterator(int32_t t, uint64_t pk) {
+    _iterators.emplace_back(t, pk);
+    return _iterators.size() - 1;
+}
+
+template<typename Key>
+std::pair<int32_t, uint64_t> secondary_index<Key>::deref(int32_t itr)const {
+    if (itr < 0 || itr >= (int32_t)_iterators.size())
+        fail("invalid secondary iterator");
+    auto ref = _iterators[itr];
+    if (!_tables[ref.first]->by_primary.count(ref.second))
+        fail("dereference of deleted secondary object");
+    return ref;
+}
+
+template<typename Key>
+void secondary_index<Key>::set_entry(int32_t t, uint64_t pk, const entry* e) {
+    auto& tbl       = *_tables[t];
+    auto existing   = tbl.by_primary.find(pk);
+    bool had        = existing != tbl.by_primary.end();
+    bool was_empty  = tbl.by_primary.empty();
+    entry old       = had ? existing->second : entry{};
+    constexpr auto cost = secondary_ram_bytes<Key>::value;
+
+    if (had) {
+        _db.bill(old.payer, -cost);
+        tbl.by_secondary.erase({ old.key, pk });
+        tbl.by_primary.erase(existing);
+    }
+    if (e != nullptr) {
+        _db.bill(e->payer, cost);
+        tbl.by_primary.emplace(pk, *e);
+        tbl.by_secondary.emplace(e->key, pk);
+    }
+
+    if (was_empty && !tbl.by_primary.empty()) {
+        tbl.payer = e->payer;
+        _db.bill(tbl.payer, table_ram_bytes);
+    } else if (!was_empty && tbl.by_primary.empty()) {
+        _db.bill(tbl.payer, -table_ram_bytes);
+    }
+
+    _db.journal([this, t, pk, had, old]() { set_entry(t, pk, had ? &old : nullptr); });
+}
+
+template<typename Key>
+int32_t secondary_index<Key>::store(uint64_t code, uint64_t scope, uint64_t tbl, uint64_t payer, uint64_t pk, const Key& key) {
+    ++_db._counters.secondary_writes;
+    if (payer == 0) fail("must specify a valid account to pay for new record");
+
+    auto t = get_or_create_table({ code, scope, tbl });
+    if (_tables[t]->by_primary.count(pk)) fail("secondary index row with the same primary key already exists");
+
+    entry e{ key, payer };
+    set_entry(t, pk, &e);
+    return add_iterator(t, pk);
+}
+
+template<typename Key>
+void secondary_index<Key>::update(int32_t itr, uint64_t payer, const Key& key) {
+    ++_db._counters.secondary_writes;
+    auto ref = deref(itr);
+    auto e   = _tables[ref.first]->by_primary.at(ref.second);
+    if (payer != 0) e.payer = payer;
+    e.key    = key;
+    set_entry(ref.first, ref.second, &e);
+}
+
+template<typename Key>
+void secondary_index<Key>::remove(int32_t itr) {
+    ++_db._counters.secondary_writes;
+    auto ref = deref(itr);
+    set_entry(ref.first, ref.second, nullptr);
+}
+
+template<typename Key>
+int32_t secondary_index<Key>::next(int32_t itr, uint64_t& pk) {
+    ++_db._counters.secondary_reads;
+    if (itr < -1) return -1;    // cannot increment past the end iterator
+    auto ref  = deref(itr);
+    auto& tbl = *_tables[ref.first];
+    auto pos  = tbl.by_secondary.upper_bound({ tbl.by_primary.at(ref.second).key, ref.second });
+    if (pos == tbl.by_secondary.end())
+        return end_iterator(ref.first);
+
+    pk = pos->second;
+    return add_iterator(ref.first, pk);
+}
+
+template<typename Key>
+int32_t secondary_index<Key>::previous(int32_t itr, uint64_t& pk) {
+    ++_db._counters.secondary_reads;
+    if (itr < -1) {
+        int32_t t = -itr - 2;
+        if (t >= (int32_t)_tables.size()) fail("invalid secondary end iterator");
+        auto& tbl = *_tables[t];
+        if (tbl.by_secondary.empty()) return -1;
+        pk = tbl.by_secondary.rbegin()->second;
+        return add_iterator(t, pk);
+    }
+
+    auto ref  = deref(itr);
+    auto& tbl = *_tables[ref.first];
+    auto pos  = tbl.by_secondary.find({ tbl.by_primary.at(ref.second).key, ref.second });
+    if (pos == tbl.by_secondary.begin()) return -1;
+    --pos;
+    pk = pos->second;
+    return add_iterator(ref.first, pk);
+}
+
+template<typename Key>
+int32_t secondary_index<Key>::find_primary(uint64_t code, uint64_t scope, uint64_t tbl, Key& key, uint64_t pk) {
+    ++_db._counters.secondary_reads;
+    auto t = find_table({ code, scope, tbl });
+    if (t < 0) return -1;
+
+    auto& entries = _tables[t]->by_primary;
+    auto itr = entries.find(pk);
+    if (itr == entries.end()) return end_iterator(t);
+
+    key = itr->second.key;
+    return add_iterator(t, pk);
+}
+
+template<typename Key>
+int32_t secondary_index<Key>::find_secondary(uint64_t code, uint64_t scope, uint64_t tbl, const Key& key, uint64_t& pk) {
+    ++_db._counters.secondary_reads;
+    auto t = find_table({ code, scope, tbl });
+    if (t < 0) return -1;
+
+    auto& entries = _tables[t]->by_secondary;
+    auto itr = entries.lower_bound({ key, 0 });
+    if (itr == entries.end() || itr->first != key) return end_iterator(t);
+
+    pk = itr->second;
+    return add_iterator(t, pk);
+}
+
+template<typename Key>
+int32_t secondary_index<Key>::bound(uint64_t code, uint64_t scope, uint64_t tbl, Key& key, uint64_t& pk, bool upper) {
+    ++_db._counters.secondary_reads;
+    auto t = find_table({ code, scope, tbl });
+    if (t < 0) return -1;
+
+    auto& entries = _tables[t]->by_secondary;
+    auto itr = upper ? entries.upper_bound({ key, UINT64_MAX }) : entries.lower_bound({ key, 0 });
+    if (itr == entries.end()) return end_iterator(t);
+
+    key = itr->first;
+    pk  = itr->second;
+    return add_iterator(t, pk);
+}
+
+template<typename Key>
+int32_t secondary_index<Key>::lowerbound(uint64_t code, uint64_t scope, uint64_t tbl, Key& key, uint64_t& pk) {
+    return bound(code, scope, tbl, key, pk, false);
+}
+
+template<typename Key>
+int32_t secondary_index<Key>::upperbound(uint64_t code, uint64_t scope, uint64_t tbl, Key& key, uint64_t& pk) {
+    return bound(code, scope, tbl, key, pk, true);
+}
+
+template<typename Key>
+int32_t secondary_index<Key>::end(uint64_t code, uint64_t scope, uint64_t tbl) {
+    ++_db._counters.secondary_reads;
+    auto t = find_table({ code, scope, tbl });
+    return t < 0 ? -1 : end_iterator(t);
+}
+
+} //namespace harness
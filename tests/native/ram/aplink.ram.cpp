@@ -0,0 +1,43 @@
+#include <aplink.token/aplink.token.hpp>
+
+#include "bench.hpp"
+#include "ram.hpp"
+
+using namespace eosio;
+using aplink::token;
+using ram::scale;
+
+static constexpr name   token_contract  = "aplink.token"_n;
+static constexpr name   issuer          = "aplinkadmin"_n;
+
+int main(int argc, char** argv) {
+    ram::analyzer analyzer(token_contract.to_string().c_str(), argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, issuer });
+
+    bench::setup<token>(token_contract, { token_contract }, [&](auto& t) {
+        t.create( issuer, asset(10'000'000'000'0000, APL_SYMBOL) );
+    });
+    bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+        t.setacctperms( issuer, issuer, APL_SYMBOL, true, true );
+    });
+    bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+        t.issue( issuer, asset(1'000'000'000'0000, APL_SYMBOL), "" );
+    });
+    for (uint32_t i = 0; i < 4; ++i) {
+        auto holder = bench::account("holder", i);
+        c.create_account( holder );
+        bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+            t.transfer( issuer, holder, asset(100'0000, APL_SYMBOL), "" );
+        });
+    }
+
+    analyzer.add(ram::table<asset, bool, bool, asset, time_point>(
+        "accounts"_n, "account", scale::holdings, scale::holders,
+        { "balance", "allow_send", "allow_recv", "sum_balance", "expired_at" }));
+    analyzer.add(ram::table<asset, asset, name>(
+        "stat"_n, "currency_stats", scale::tokens, scale::tokens, { "supply", "max_supply", "issuer" }));
+
+    return analyzer.report();
+}
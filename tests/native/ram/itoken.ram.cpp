@@ -0,0 +1,55 @@
+#include <verso.itoken/verso.itoken.hpp>
+
+#include "bench.hpp"
+#include "ram.hpp"
+
+using namespace eosio;
+using namespace amax;
+using ram::scale;
+
+static constexpr name   token_contract  = "verso.itoken"_n;
+static constexpr name   issuer          = "issuer"_n;
+static constexpr name   notary          = "notary"_n;
+
+/// token uris are IPFS CIDv0 links in practice
+static string token_uri(uint32_t id) {
+    auto cid = "Qm" + std::string(44 - std::to_string(id).size(), 'x') + std::to_string(id);
+    return "ipfs://" + cid;
+}
+
+int main(int argc, char** argv) {
+    ram::analyzer analyzer(token_contract.to_string().c_str(), argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, issuer, notary });
+
+    bench::setup<itoken>(token_contract, { token_contract }, [&](auto& t) {
+        t.setnotary( notary, true );
+    });
+    for (uint32_t id = 1; id <= 4; ++id) {
+        bench::setup<itoken>(token_contract, { issuer }, [&](auto& t) {
+            t.create( issuer, 1'000, nsymbol(id, 0), token_uri(id), issuer );
+        });
+        bench::setup<itoken>(token_contract, { issuer }, [&](auto& t) {
+            t.issue( issuer, nasset(int64_t(1'000), nsymbol(id, 0)), "" );
+        });
+
+        auto holder = bench::account("holder", id);
+        c.create_account( holder );
+        bench::setup<itoken>(token_contract, { issuer }, [&](auto& t) {
+            t.transfer( issuer, holder, { nasset(int64_t(1), nsymbol(id, 0)) }, "" );
+        });
+    }
+
+    analyzer.add(ram::table<set<name>, set<name>>(
+        "global"_n, "global_t", scale::fixed, scale::fixed, { "notaries", "whitelist" }));
+    analyzer.add(ram::table<nasset, nasset, string, name, name, name, time_point_sec, time_point_sec, bool>(
+        "tokenstats"_n, "nstats_t", scale::tokens, scale::fixed,
+        { "supply", "max_supply", "token_uri", "ipowner", "notary", "issuer", "issued_at", "notarized_at", "paused" },
+        { ram::idx64("parentidx"), ram::idx64("ipowneridx"), ram::idx64("issueridx"),
+          ram::idx128("issuercreate"), ram::idx256("tokenuriidx") }));
+    analyzer.add(ram::table<nasset, bool>(
+        "accounts"_n, "account_t", scale::holdings, scale::holders, { "balance", "paused" }));
+
+    return analyzer.report();
+}
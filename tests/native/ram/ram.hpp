@@ -0,0 +1,262 @@
+#pragma once
+
+#include <chain.hpp>
+
+#include <eosio/datastream.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * RAM footprint of the contract tables.
+ *
+ * Sample rows are created by real actions on the native chain harness. Every row
+ * is then decoded field by field with a layout that mirrors the EOSLIB_SERIALIZE
+ * list of its struct, which gives the exact serialized size of each field. With
+ * the billable sizes of the chain objects (row, table and secondary index entry,
+ * see store.hpp) the cost of one row is projected onto N holders, M tokens and
+ * K slots, and the field or index that dominates each table is reported.
+ *
+ * usage: <contract>.ram [--holders N] [--tokens M] [--slots K] [--held H]
+ *
+ * where H is the number of token rows held by each holder.
+ */
+namespace ram {
+
+using eosio::name;
+
+/// how the number of rows or scopes of a table grows
+enum class scale {
+    holders,    // one per holder
+    tokens,     // one per token
+    slots,      // one per slot
+    holdings,   // one per holder and held token
+    fixed,      // as many as in the sample (global state, config tables, ...)
+};
+
+struct params {
+    uint64_t    holders     = 1'000'000;
+    uint64_t    tokens      = 1'000;
+    uint64_t    slots       = 100;
+    uint64_t    held        = 1;
+
+    params(int argc, char** argv) {
+        for (int i = 1; i + 1 < argc; i += 2) {
+            uint64_t value = std::strtoull(argv[i + 1], nullptr, 10);
+            if      (!std::strcmp(argv[i], "--holders"))   holders = value;
+            else if (!std::strcmp(argv[i], "--tokens"))    tokens  = value;
+            else if (!std::strcmp(argv[i], "--slots"))     slots   = value;
+            else if (!std::strcmp(argv[i], "--held"))      held    = value;
+        }
+    }
+
+    uint64_t count(scale s, uint64_t sampled)const {
+        switch (s) {
+            case scale::holders:    return holders;
+            case scale::tokens:     return tokens;
+            case scale::slots:      return slots;
+            case scale::holdings:   return holders * held;
+            case scale::fixed:      return sampled;
+        }
+        return sampled;
+    }
+};
+
+struct index_def {
+    std::string     name;
+    int64_t         bytes;      // billable size of one entry
+};
+
+inline index_def idx64(const std::string& name)  { return { name, harness::secondary_ram_bytes<uint64_t>::value }; }
+inline index_def idx128(const std::string& name) { return { name, harness::secondary_ram_bytes<harness::uint128>::value }; }
+inline index_def idx256(const std::string& name) { return { name, harness::secondary_ram_bytes<harness::key256>::value }; }
+
+using decoder = std::function<std::vector<uint64_t>(const std::vector<char>&)>;
+
+struct table_def {
+    name                        table;
+    std::string                 row;
+    scale                       rows;
+    scale                       scopes;
+    std::vector<std::string>    fields;
+    std::vector<index_def>      indices;
+    decoder                     decode;
+};
+
+/// serialized size of each field of a row; `Fields` mirror the EOSLIB_SERIALIZE list of the row
+template<typename... Fields>
+std::vector<uint64_t> decode(const std::vector<char>& data) {
+    eosio::datastream<const char*> ds(data.data(), data.size());
+    std::vector<uint64_t> sizes;
+    auto read = [&](auto&& field) {
+        auto start = ds.tellp();
+        ds >> field;
+        sizes.push_back(ds.tellp() - start);
+    };
+    (read(Fields{}), ...);
+
+    if (ds.remaining() != 0) {
+        std::fprintf(stderr, "ram: row layout is out of date, %zu trailing bytes\n", ds.remaining());
+        std::exit(-1);
+    }
+    return sizes;
+}
+
+template<typename... Fields>
+table_def table(name tbl, const std::string& row, scale rows, scale scopes,
+                const std::vector<std::string>& fields, const std::vector<index_def>& indices = {}) {
+    if (fields.size() != sizeof...(Fields)) {
+        std::fprintf(stderr, "ram: %s declares %zu field names for %zu fields\n", row.c_str(), fields.size(), sizeof...(Fields));
+        std::exit(-1);
+    }
+    return { tbl, row, rows, scopes, fields, indices, &decode<Fields...> };
+}
+
+class analyzer {
+public:
+    analyzer(const char* contract, int argc, char** argv): _contract(contract), _params(argc, argv) {
+        harness::chain::get().reset();
+    }
+
+    void add(const table_def& def) { _tables.push_back(def); }
+
+    /// prints the per-table breakdown and the projection, returns the process exit code
+    int report() {
+        std::printf("%s: projection for %llu holders, %llu tokens, %llu slots, %llu held tokens per holder\n",
+                    _contract.to_string().c_str(), (unsigned long long)_params.holders, (unsigned long long)_params.tokens,
+                    (unsigned long long)_params.slots, (unsigned long long)_params.held);
+
+        double total = 0;
+        std::string top_table, top_component;
+        double top_table_bytes = 0, top_component_bytes = 0;
+
+        for (const auto& def : _tables) {
+            auto t = analyze(def);
+            total += t.projected;
+            if (t.projected > top_table_bytes) {
+                top_table_bytes = t.projected;
+                top_table       = def.table.to_string();
+            }
+            if (t.dominant_bytes > top_component_bytes) {
+                top_component_bytes = t.dominant_bytes;
+                top_component       = def.table.to_string() + "." + t.dominant;
+            }
+        }
+
+        std::printf("\n%s total: %s", _contract.to_string().c_str(), human(total).c_str());
+        if (total > 0)
+            std::printf(", largest table: %s (%.1f%%), largest component: %s (%.1f%%)",
+                        top_table.c_str(), 100 * top_table_bytes / total, top_component.c_str(), 100 * top_component_bytes / total);
+        std::printf("\n");
+        return 0;
+    }
+
+private:
+    struct result {
+        double          projected       = 0;
+        std::string     dominant;
+        double          dominant_bytes  = 0;
+    };
+
+    result analyze(const table_def& def) {
+        auto& db = harness::chain::get().db();
+
+        uint64_t rows = 0, data = 0;
+        std::set<uint64_t> scopes;
+        std::vector<uint64_t> fields(def.fields.size(), 0);
+        for (const auto& t : db.tables()) {
+            if (t->id.code != _contract.value || t->id.table != def.table.value || t->rows.empty())
+                continue;
+            scopes.insert(t->id.scope);
+            for (const auto& r : t->rows) {
+                auto sizes = def.decode(r.second.data);
+                for (size_t i = 0; i < sizes.size(); ++i) fields[i] += sizes[i];
+                data += r.second.data.size();
+                ++rows;
+            }
+        }
+
+        std::printf("\n%-12s (%s)", def.table.to_string().c_str(), def.row.c_str());
+        if (rows == 0) {
+            std::printf(": no sample rows\n");
+            return {};
+        }
+
+        auto entries = count_entries(db.idx64(), def) + count_entries(db.idx128(), def) + count_entries(db.idx256(), def);
+        if (entries != rows * def.indices.size()) {
+            std::fprintf(stderr, "ram: %s has %llu secondary entries, the layout declares %llu\n", def.table.to_string().c_str(),
+                         (unsigned long long)entries, (unsigned long long)(rows * def.indices.size()));
+            std::exit(-1);
+        }
+
+        const uint64_t n_rows   = _params.count(def.rows, rows);
+        const uint64_t n_scopes = std::min(_params.count(def.scopes, scopes.size()), n_rows);
+        std::printf(": %llu rows in %llu scopes, sampled %llu rows of %.1f bytes\n",
+                    (unsigned long long)n_rows, (unsigned long long)n_scopes, (unsigned long long)rows, double(data) / rows);
+        if (n_rows == 0) return {};
+
+        std::printf("  %-28s %12s %14s %8s\n", "component", "bytes/row", "projected", "share");
+
+        // each scope holds one table_id_object for the rows and one per secondary index
+        const double scope_bytes = harness::table_ram_bytes * (1 + def.indices.size());
+
+        std::vector<std::pair<std::string, double>> components;
+        components.emplace_back("row overhead", harness::row_ram_bytes);
+        for (size_t i = 0; i < def.fields.size(); ++i)
+            components.emplace_back(def.fields[i], double(fields[i]) / rows);
+        for (const auto& idx : def.indices)
+            components.emplace_back("index " + idx.name, idx.bytes);
+        components.emplace_back("table ids per scope", scope_bytes * n_scopes / n_rows);
+
+        double per_row = 0;
+        for (const auto& c : components) per_row += c.second;
+
+        result r;
+        r.projected = per_row * n_rows;
+        for (const auto& c : components) {
+            double bytes = c.second * n_rows;
+            std::printf("  %-28s %12.1f %14s %7.1f%%\n", c.first.c_str(), c.second, human(bytes).c_str(), 100 * bytes / r.projected);
+            if (bytes > r.dominant_bytes) {
+                r.dominant_bytes = bytes;
+                r.dominant       = c.first;
+            }
+        }
+        std::printf("  %-28s %12.1f %14s\n", "total", per_row, human(r.projected).c_str());
+        std::printf("  dominated by %s\n", r.dominant.c_str());
+        return r;
+    }
+
+    /// secondary index tables of `def` are named after it with the index number in the low 4 bits
+    template<typename Index>
+    uint64_t count_entries(const Index& idx, const table_def& def)const {
+        const uint64_t prefix = def.table.value & 0xFFFFFFFFFFFFFFF0ULL;
+        uint64_t entries = 0;
+        for (const auto& t : idx.tables()) {
+            if (t->id.code == _contract.value && (t->id.table & 0xFFFFFFFFFFFFFFF0ULL) == prefix
+                    && (t->id.table & 0xF) < def.indices.size())
+                entries += t->by_primary.size();
+        }
+        return entries;
+    }
+
+    static std::string human(double bytes) {
+        static const char* units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+        int u = 0;
+        while (bytes >= 1024 && u < 4) { bytes /= 1024; ++u; }
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), u == 0 ? "%.0f %s" : "%.2f %s", bytes, units[u]);
+        return buf;
+    }
+
+    name                    _contract;
+    params                  _params;
+    std::vector<table_def>  _tables;
+};
+
+} //namespace ram
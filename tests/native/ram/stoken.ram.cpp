@@ -0,0 +1,61 @@
+#include <amax.stoken/amax.stoken.hpp>
+
+#include "bench.hpp"
+#include "ram.hpp"
+
+using namespace eosio;
+using namespace amax;
+using ram::scale;
+
+static constexpr name   token_contract  = "amax.stoken"_n;
+static constexpr name   admin           = "armoniaadmin"_n;
+static constexpr name   creator         = "creator"_n;
+
+int main(int argc, char** argv) {
+    ram::analyzer analyzer(token_contract.to_string().c_str(), argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, admin, creator });
+
+    bench::setup<stoken>(token_contract, { admin }, [&](auto& t) {
+        t.addslotkey( "grade"_n, slot_perm::ADMIN, { admin } );
+    });
+    for (uint64_t id = 1; id <= 4; ++id) {
+        // slot 1 is shared, the others belong to the creator
+        auto meta_uri = "ipfs://Qm" + std::string(43, 'x') + std::to_string(id);
+        bench::setup<stoken>(token_contract, { admin }, [&](auto& t) {
+            t.addslot( id == 1 ? name(0) : creator, meta_uri, { { "grade"_n, "gold" }, { "edition"_n, "2023" } } );
+        });
+        bench::setup<stoken>(token_contract, { creator }, [&](auto& t) {
+            t.create( creator, 0, id, 1'000'000 );     // SFT id == slot id
+        });
+        bench::setup<stoken>(token_contract, { creator }, [&](auto& t) {
+            t.issue( creator, sasset(id, slot_s(id, id), 1'000), "" );
+        });
+
+        auto holder = bench::account("holder", id);
+        c.create_account( holder );
+        bench::setup<stoken>(token_contract, { creator }, [&](auto& t) {
+            t.transfer( creator, holder, sasset(id, slot_s(id, id), 1), "" );
+        });
+    }
+
+    analyzer.add(ram::table<name, uint64_t, uint64_t, uint64_t>(
+        "global"_n, "global_t", scale::fixed, scale::fixed, { "admin", "last_slot_id", "last_slot_hid", "last_sft_id" }));
+    analyzer.add(ram::table<name, name, set<name>>(
+        "slotkeys"_n, "slot_key_t", scale::fixed, scale::fixed, { "title", "perm_type", "admins" }));
+    analyzer.add(ram::table<uint64_t, name, map<name, string>, string, time_point_sec>(
+        "slots"_n, "slot_t", scale::slots, scale::fixed, { "id", "owner", "properties", "meta_uri", "created_at" },
+        { ram::idx64("slotowner"), ram::idx256("slothash") }));
+    analyzer.add(ram::table<uint64_t, checksum256>(
+        "slothash"_n, "slot_hash_t", scale::slots, scale::fixed, { "id", "hash" },
+        { ram::idx256("slothash") }));
+    analyzer.add(ram::table<sasset, name, time_point_sec>(
+        "sftstats"_n, "sft_stats_t", scale::tokens, scale::fixed, { "supply", "creator", "created_at" },
+        { ram::idx64("slothid") }));
+    analyzer.add(ram::table<sasset>(
+        "accounts"_n, "account_t", scale::holdings, scale::holders, { "balance" },
+        { ram::idx64("slothid") }));
+
+    return analyzer.report();
+}
@@ -0,0 +1,62 @@
+#include <amax.token/amax.token.hpp>
+
+#include "bench.hpp"
+#include "ram.hpp"
+
+using namespace eosio;
+using ram::scale;
+
+static constexpr name   token_contract  = "amax.token"_n;
+static constexpr name   issuer          = "amax"_n;
+static constexpr symbol AMAX            = symbol("AMAX", 8);
+
+int main(int argc, char** argv) {
+    ram::analyzer analyzer(token_contract.to_string().c_str(), argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, issuer });
+
+    bench::setup<token>(token_contract, { token_contract }, [&](auto& t) {
+        t.create( issuer, asset(10'000'000'000'00000000, AMAX) );
+    });
+    bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+        t.issue( issuer, asset(1'000'000'000'00000000, AMAX), "" );
+    });
+    for (uint32_t i = 0; i < 4; ++i) {
+        auto holder = bench::account("holder", i);
+        c.create_account( holder );
+        bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+            t.transfer( issuer, holder, asset(1'00000000, AMAX), "" );
+        });
+    }
+    bench::setup<token>(token_contract, { token_contract }, [&](auto& t) {
+        t.blacklist( { bench::account("holder", 0) }, true );
+    });
+    // a staged blacklist update of 100 accounts, half applied
+    std::vector<name> targets;
+    for (uint32_t i = 0; i < 100; ++i)
+        targets.push_back( bench::account("black", i) );
+    bench::setup<token>(token_contract, { token_contract }, [&](auto& t) {
+        t.stageblack( targets, true );
+    });
+    bench::setup<token>(token_contract, { token_contract }, [&](auto& t) {
+        t.applyblack( 50 );
+    });
+
+    analyzer.add(ram::table<asset>(
+        "accounts"_n, "account", scale::holdings, scale::holders, { "balance" }));
+    analyzer.add(ram::table<asset, asset, name>(
+        "stat"_n, "currency_stats", scale::tokens, scale::tokens, { "supply", "max_supply", "issuer" }));
+    analyzer.add(ram::table<name>(
+        "blacklist"_n, "blacklist_t", scale::fixed, scale::fixed, { "account" }));
+    analyzer.add(ram::table<uint64_t, name, bool>(
+        "blackstage"_n, "blackstage_t", scale::fixed, scale::fixed, { "id", "target", "to_add" }));
+    analyzer.add(ram::table<uint64_t, uint64_t, int64_t, bool, name>(
+        "holderstats"_n, "holder_stats", scale::tokens, scale::tokens,
+        { "holders", "tracked", "min_listed", "initialized", "seeded" }));
+    // at most max_top_holders (100) rows per token, the sample lists the 5 holders of its one token
+    analyzer.add(ram::table<name, asset>(
+        "topholders"_n, "top_holder", scale::fixed, scale::fixed, { "owner", "balance" }, { ram::idx64("bybalance") }));
+
+    return analyzer.report();
+}
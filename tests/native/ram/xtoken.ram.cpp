@@ -0,0 +1,52 @@
+#include <amax.xtoken/amax.xtoken.hpp>
+
+#include "bench.hpp"
+#include "ram.hpp"
+
+using namespace eosio;
+using amax_xtoken::xtoken;
+using ram::scale;
+
+static constexpr name   token_contract  = "amax.xtoken"_n;
+static constexpr name   issuer          = "issuer"_n;
+static constexpr name   fee_receiver    = "feereceiver"_n;
+static constexpr symbol XT              = symbol("XT", 4);
+
+int main(int argc, char** argv) {
+    ram::analyzer analyzer(token_contract.to_string().c_str(), argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, issuer, fee_receiver });
+
+    bench::setup<xtoken>(token_contract, { token_contract }, [&](auto& t) {
+        t.create( issuer, asset(10'000'000'000'0000, XT) );
+    });
+    bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+        t.issue( issuer, asset(1'000'000'000'0000, XT), "" );
+    });
+    bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+        t.feereceiver( XT, fee_receiver );
+    });
+    bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+        t.feeratio( XT, 30 );
+    });
+    for (uint32_t i = 0; i < 4; ++i) {
+        auto holder = bench::account("holder", i);
+        c.create_account( holder );
+        bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+            t.transfer( issuer, holder, asset(100'0000, XT), "" );
+        });
+    }
+
+    analyzer.add(ram::table<asset, bool, bool>(
+        "accounts"_n, "account", scale::holdings, scale::holders, { "balance", "is_frozen", "is_fee_exempt" }));
+    analyzer.add(ram::table<asset, asset, name, bool, name, uint64_t, asset>(
+        "stat"_n, "currency_stats", scale::tokens, scale::tokens,
+        { "supply", "max_supply", "issuer", "is_paused", "fee_receiver", "fee_ratio", "min_fee_quantity" }));
+    // up to max_fee_epochs (90) ring rows plus the retired totals of each token with feeepoch set
+    analyzer.add(ram::table<uint64_t, uint64_t, asset, uint64_t, uint64_t, uint64_t, uint32_t>(
+        "feestats"_n, "fee_stats", scale::tokens, scale::tokens,
+        { "id", "epoch", "fees", "taxed_transfers", "zero_fee_transfers", "exempt_transfers", "epoch_secs" }));
+
+    return analyzer.report();
+}
@@ -0,0 +1,43 @@
+#include <aplink.token/aplink.token.hpp>
+
+#include "bench.hpp"
+#include "scale.hpp"
+
+using namespace eosio;
+using aplink::token;
+
+static constexpr name   token_contract  = "aplink.token"_n;
+static constexpr name   issuer          = "aplinkadmin"_n;
+
+int main(int argc, char** argv) {
+    scale::curve curve("aplink.token", argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, issuer, "bob"_n });
+
+    bench::setup<token>(token_contract, { token_contract }, [&](auto& t) {
+        t.create( issuer, asset(10'000'000'000'0000, APL_SYMBOL) );
+    });
+    bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+        t.setacctperms( issuer, issuer, APL_SYMBOL, true, true );
+    });
+    bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+        t.issue( issuer, asset(1'000'000'000'0000, APL_SYMBOL), "" );
+    });
+
+    // holder scopes
+    uint32_t holders = 0;
+    curve.run<token>("transfer/holders", [&](uint64_t size) {
+        for (; holders < size; ++holders) {
+            auto holder = bench::account("h", holders, 6);
+            c.create_account( holder );
+            bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+                t.transfer( issuer, holder, asset(1, APL_SYMBOL), "" );
+            });
+        }
+    }, token_contract, { issuer }, [&](auto& t, uint64_t i) {
+        t.transfer( issuer, "bob"_n, asset(1, APL_SYMBOL), "" );
+    });
+
+    return curve.finish();
+}
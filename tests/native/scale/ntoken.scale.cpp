@@ -0,0 +1,50 @@
+#include <amax.ntoken/amax.ntoken.hpp>
+
+#include "bench.hpp"
+#include "scale.hpp"
+
+using namespace eosio;
+using namespace amax;
+
+static constexpr name   token_contract  = "amax.ntoken"_n;
+
+int main(int argc, char** argv) {
+    scale::curve curve("amax.ntoken", argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, "alice"_n, "bob"_n });
+
+    // alice creates every token and receives the issued supply
+    uint32_t tokens = 0;
+    auto grow_tokens = [&](uint64_t size) {
+        for (; tokens < size; ++tokens) {
+            auto id = tokens + 1;
+            bench::setup<ntoken>(token_contract, { "alice"_n }, [&](auto& t) {
+                t.create( "alice"_n, 1'000'000'000, nsymbol(id, 0), "ipfs://token/" + std::to_string(id), name() );
+            });
+        }
+    };
+    uint32_t held = 0;
+    auto grow_held = [&](uint64_t size) {
+        grow_tokens(size);
+        for (; held < size; ++held) {
+            auto id = held + 1;
+            bench::setup<ntoken>(token_contract, { "alice"_n }, [&](auto& t) {
+                t.issue( "alice"_n, nasset(int64_t(1'000'000'000), nsymbol(id, 0)), "" );
+            });
+        }
+    };
+    grow_held(1);
+
+    auto transfer = [&](auto& t, uint64_t i) {
+        t.transfer( "alice"_n, "bob"_n, { nasset(int64_t(1), nsymbol(1, 0)) }, "" );
+    };
+
+    // rows of nstats_t and its five secondary indices
+    curve.run<ntoken>("transfer/tokens", grow_tokens, token_contract, { "alice"_n }, transfer);
+
+    // rows in the sender's accounts scope
+    curve.run<ntoken>("transfer/held", grow_held, token_contract, { "alice"_n }, transfer);
+
+    return curve.finish();
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chain.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Cost versus table size of the hot actions.
+ *
+ * For every size of the curve the table under test is grown to that size by a
+ * `grow` callback, then `samples` actions are measured. A case is flagged when
+ * its DB operation count grows with the table size, or when its CPU time grows
+ * faster than size^max-exponent between the smallest and the largest size.
+ *
+ * usage: <contract>.scale [--sizes 1000,10000,100000,1000000] [-n samples]
+ *                         [--max-exponent 0.5] [--skip-cpu] [--csv file]
+ */
+namespace scale {
+
+class curve {
+public:
+    curve(const char* contract, int argc, char** argv): _contract(contract) {
+        for (int i = 1; i < argc; ++i) {
+            if (!std::strcmp(argv[i], "--sizes") && i + 1 < argc)              parse_sizes(argv[++i]);
+            else if (!std::strcmp(argv[i], "-n") && i + 1 < argc)              _samples = std::atoi(argv[++i]);
+            else if (!std::strcmp(argv[i], "--max-exponent") && i + 1 < argc)  _max_exponent = std::atof(argv[++i]);
+            else if (!std::strcmp(argv[i], "--csv") && i + 1 < argc)           _csv = std::fopen(argv[++i], "a");
+            else if (!std::strcmp(argv[i], "--skip-cpu"))                      _skip_cpu = true;
+        }
+        if (_sizes.empty()) _sizes = { 1'000, 10'000, 100'000, 1'000'000 };
+        std::sort(_sizes.begin(), _sizes.end());
+
+        harness::chain::get().reset();
+        std::printf("%-14s %-24s %10s %10s %10s %8s\n", "contract", "case", "size", "cpu(us)", "p90(us)", "db_ops");
+    }
+
+    ~curve() { if (_csv) std::fclose(_csv); }
+
+    int samples()const { return _samples; }
+
+    /// grow( size ) brings the table under test to `size` rows; func( contract, sample ) performs one action
+    template<typename Contract, typename Grow, typename Func>
+    void run(const std::string& name, Grow&& grow, const eosio::name& self, const std::vector<eosio::name>& auths, Func&& func) {
+        auto& c = harness::chain::get();
+
+        std::vector<point> points;
+        for (auto size : _sizes) {
+            grow(size);
+
+            std::vector<int64_t> cpu;
+            uint64_t db_ops = 0;
+            for (int i = 0; i < _samples; ++i) {
+                const auto& r = c.push<Contract>(self, auths, [&](auto& contract) { func(contract, _sample++); });
+                if (r.failed) {
+                    std::printf("%-14s %-24s FAILED at size %llu: %s\n", _contract, name.c_str(), (unsigned long long)size, r.error.c_str());
+                    ++_violations;
+                    return;
+                }
+                cpu.push_back(r.elapsed_ns);
+                db_ops = std::max(db_ops, r.db.total());
+            }
+
+            std::sort(cpu.begin(), cpu.end());
+            point p{ size, cpu[cpu.size() / 2] / 1000.0, cpu[cpu.size() * 9 / 10] / 1000.0, db_ops };
+            points.push_back(p);
+
+            std::printf("%-14s %-24s %10llu %10.2f %10.2f %8llu\n", _contract, name.c_str(), (unsigned long long)p.size,
+                        p.cpu_us, p.p90_us, (unsigned long long)p.db_ops);
+            if (_csv)
+                std::fprintf(_csv, "%s,%s,%llu,%.3f,%.3f,%llu\n", _contract, name.c_str(), (unsigned long long)p.size,
+                             p.cpu_us, p.p90_us, (unsigned long long)p.db_ops);
+        }
+        check(name, points);
+    }
+
+    /// returns the process exit code: the number of flagged cases
+    int finish() {
+        std::printf("%d violation(s)\n", _violations);
+        return _violations;
+    }
+
+private:
+    struct point {
+        uint64_t    size;
+        double      cpu_us;
+        double      p90_us;
+        uint64_t    db_ops;
+    };
+
+    void check(const std::string& name, const std::vector<point>& points) {
+        if (points.size() < 2) return;
+        const auto& first = points.front();
+        const auto& last  = points.back();
+
+        std::string status;
+        if (last.db_ops > first.db_ops)
+            status += " db ops grow " + std::to_string(first.db_ops) + " -> " + std::to_string(last.db_ops);
+
+        double exponent = std::log(last.cpu_us / first.cpu_us) / std::log(double(last.size) / first.size);
+        if (!_skip_cpu && exponent > _max_exponent)
+            status += " cpu ~ size^" + std::to_string(exponent);
+
+        if (!status.empty()) ++_violations;
+        std::printf("%-14s %-24s cpu ~ size^%.2f %s\n", _contract, name.c_str(), exponent, status.empty() ? "ok" : status.c_str());
+    }
+
+    void parse_sizes(const char* list) {
+        char* p = const_cast<char*>(list);
+        while (*p) {
+            _sizes.push_back(std::strtoull(p, &p, 10));
+            if (*p != ',') break;
+            ++p;
+        }
+    }
+
+    const char*             _contract;
+    std::vector<uint64_t>   _sizes;
+    int                     _samples        = 50;
+    double                  _max_exponent   = 0.5;
+    bool                    _skip_cpu       = false;
+    FILE*                   _csv            = nullptr;
+    uint64_t                _sample         = 0;
+    int                     _violations     = 0;
+};
+
+} //namespace scale
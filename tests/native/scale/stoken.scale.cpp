@@ -0,0 +1,48 @@
+#include <amax.stoken/amax.stoken.hpp>
+
+#include "bench.hpp"
+#include "scale.hpp"
+
+using namespace eosio;
+using namespace amax;
+
+static constexpr name   token_contract  = "amax.stoken"_n;
+static constexpr name   admin           = "armoniaadmin"_n;
+
+static string meta_uri(uint64_t i) { return "ipfs://slot/" + std::to_string(i); }
+
+int main(int argc, char** argv) {
+    scale::curve curve("amax.stoken", argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, admin, "alice"_n, "bob"_n });
+
+    // slot 1 is shared, SFT 1 on it is held by alice
+    uint64_t slots = 0;
+    auto grow_slots = [&](uint64_t size) {
+        for (; slots < size; ++slots) {
+            bench::setup<stoken>(token_contract, { admin }, [&](auto& t) {
+                t.addslot( name(0), meta_uri(slots + 1), { { "grade"_n, "gold" } } );
+            });
+        }
+    };
+    grow_slots(1);
+    bench::setup<stoken>(token_contract, { "alice"_n }, [&](auto& t) {
+        t.create( "alice"_n, 0, 1, 1'000'000'000'000 );
+    });
+    bench::setup<stoken>(token_contract, { "alice"_n }, [&](auto& t) {
+        t.issue( "alice"_n, sasset(1, slot_s(1, 1), 1'000'000'000'000), "" );
+    });
+
+    // rows of slot_t and slot_hash_t with their checksum256 indices
+    curve.run<stoken>("transfer_partial/slots", grow_slots, token_contract, { "alice"_n }, [&](auto& t, uint64_t i) {
+        t.transfer( "alice"_n, "bob"_n, sasset(1, slot_s(1, 1), 1), "" );
+    });
+
+    // slots added while sampling are not part of the measured table size
+    curve.run<stoken>("addslot/slots", grow_slots, token_contract, { admin }, [&](auto& t, uint64_t i) {
+        t.addslot( name(0), "ipfs://sample/" + std::to_string(i), { { "grade"_n, "gold" } } );
+    });
+
+    return curve.finish();
+}
@@ -0,0 +1,59 @@
+#include <amax.token/amax.token.hpp>
+
+#include "bench.hpp"
+#include "scale.hpp"
+
+using namespace eosio;
+
+static constexpr name   token_contract  = "amax.token"_n;
+static constexpr name   issuer          = "amax"_n;
+static constexpr symbol AMAX            = symbol("AMAX", 8);
+
+int main(int argc, char** argv) {
+    scale::curve curve("amax.token", argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, issuer, "alice"_n, "bob"_n });
+
+    bench::setup<token>(token_contract, { token_contract }, [&](auto& t) {
+        t.create( issuer, asset(10'000'000'000'00000000, AMAX) );
+    });
+    bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+        t.issue( issuer, asset(1'000'000'000'00000000, AMAX), "" );
+    });
+    bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+        t.transfer( issuer, "alice"_n, asset(100'000'000'00000000, AMAX), "" );
+    });
+
+    auto transfer = [&](auto& t, uint64_t i) {
+        t.transfer( "alice"_n, "bob"_n, asset(1, AMAX), "" );
+    };
+
+    // blacklist rows, added 50 per action; the "bl" names sort between alice and bob, so every
+    // sample takes the second lookup, its count is budgeted by transfer_blacklist_between
+    uint32_t blacklisted = 0;
+    curve.run<token>("transfer/blacklist", [&](uint64_t size) {
+        while (blacklisted < size) {
+            std::vector<name> targets;
+            for (; blacklisted < size && targets.size() < 50; ++blacklisted)
+                targets.push_back( bench::account("bl", blacklisted, 6) );
+            bench::setup<token>(token_contract, { token_contract }, [&](auto& t) {
+                t.blacklist( targets, true );
+            });
+        }
+    }, token_contract, { "alice"_n }, transfer);
+
+    // holder scopes
+    uint32_t holders = 0;
+    curve.run<token>("transfer/holders", [&](uint64_t size) {
+        for (; holders < size; ++holders) {
+            auto holder = bench::account("h", holders, 6);
+            c.create_account( holder );
+            bench::setup<token>(token_contract, { issuer }, [&](auto& t) {
+                t.transfer( issuer, holder, asset(1, AMAX), "" );
+            });
+        }
+    }, token_contract, { "alice"_n }, transfer);
+
+    return curve.finish();
+}
@@ -0,0 +1,51 @@
+#include <amax.xtoken/amax.xtoken.hpp>
+
+#include "bench.hpp"
+#include "scale.hpp"
+
+using namespace eosio;
+using amax_xtoken::xtoken;
+
+static constexpr name   token_contract  = "amax.xtoken"_n;
+static constexpr name   issuer          = "issuer"_n;
+static constexpr name   fee_receiver    = "feereceiver"_n;
+static constexpr symbol XT              = symbol("XT", 4);
+
+int main(int argc, char** argv) {
+    scale::curve curve("amax.xtoken", argc, argv);
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, issuer, fee_receiver, "alice"_n, "bob"_n });
+
+    bench::setup<xtoken>(token_contract, { token_contract }, [&](auto& t) {
+        t.create( issuer, asset(10'000'000'000'0000, XT) );
+    });
+    bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+        t.issue( issuer, asset(1'000'000'000'0000, XT), "" );
+    });
+    bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+        t.feereceiver( XT, fee_receiver );
+    });
+    bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+        t.feeratio( XT, 30 );
+    });
+    bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+        t.transfer( issuer, "alice"_n, asset(100'000'000'0000, XT), "" );
+    });
+
+    // holder scopes
+    uint32_t holders = 0;
+    curve.run<xtoken>("transfer_fee/holders", [&](uint64_t size) {
+        for (; holders < size; ++holders) {
+            auto holder = bench::account("h", holders, 6);
+            c.create_account( holder );
+            bench::setup<xtoken>(token_contract, { issuer }, [&](auto& t) {
+                t.transfer( issuer, holder, asset(1, XT), "" );
+            });
+        }
+    }, token_contract, { "alice"_n }, [&](auto& t, uint64_t i) {
+        t.transfer( "alice"_n, "bob"_n, asset(100'0000, XT), "" );
+    });
+
+    return curve.finish();
+}
@@ -0,0 +1,102 @@
+#include <amax.stoken/amax.stoken.hpp>
+
+#include "test.hpp"
+
+using namespace eosio;
+using amax::stoken;
+using amax::slot_t;
+
+static constexpr name   token_contract  = "amax.stoken"_n;
+static constexpr name   admin           = "armoniaadmin"_n;
+
+using slot_page = wasm::db::page<slot_t, uint64_t>;
+
+int main() {
+    test::suite t("amax.stoken");
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, admin, "alice"_n, "bob"_n });
+
+    // 12 slots, every fourth owned by bob and the others by alice
+    std::vector<uint64_t> alice_slots, bob_slots;
+    for (uint64_t id = 1; id <= 12; ++id) {
+        auto owner = id % 4 == 0 ? "bob"_n : "alice"_n;
+        (owner == "bob"_n ? bob_slots : alice_slots).push_back(id);
+        t.ok<stoken>(token_contract, { admin }, [&](auto& k) {
+            k.addslot( owner, "ipfs://slot/" + std::to_string(id), { { "grade"_n, "gold" } } );
+        });
+    }
+
+    // pages through the slots of the owners within [lower, upper], `limit` rows per action
+    auto scan = [&](const name& lower, const name& upper, uint32_t limit, std::vector<uint64_t>& ids,
+                    std::vector<uint64_t>& reads) {
+        std::optional<wasm::db::cursor<uint64_t>> after;
+        do {
+            slot_page p;
+            const auto& r = t.ok<stoken>(token_contract, {}, [&](auto&) {
+                wasm::db::dbc db( token_contract );
+                p = db.range<"slotowner"_n, slot_t>( token_contract.value, lower.value, upper.value, limit, after );
+            });
+            if (r.failed) return;
+            t.expect(p.rows.size() <= limit, "page within the limit");
+            for (const auto& s : p.rows) ids.push_back(s.id);
+            if (after) reads.push_back(r.db.secondary_reads);
+            after = p.next;
+        } while (after);
+    };
+
+    // pages through the slots of `owner` with getslots, `limit` slots per action
+    auto get_slots = [&](const name& owner, uint32_t limit, std::vector<uint64_t>& ids, std::vector<uint64_t>& reads) {
+        uint64_t after = 0;
+        do {
+            amax::slots_page p;
+            const auto& r = t.ok<stoken>(token_contract, {}, [&](auto& k) {
+                p = k.getslots( owner, after, limit );
+            });
+            if (r.failed) return;
+            t.expect(p.slots.size() <= limit, "page within the limit");
+            for (const auto& s : p.slots) ids.push_back(s.id);
+            if (after) reads.push_back(r.db.secondary_reads);
+            after = p.next;
+        } while (after);
+    };
+
+    t.section("getslots/duplicate keys");
+    std::vector<uint64_t> ids, reads;
+    get_slots("alice"_n, 2, ids, reads);
+    t.expect(ids == alice_slots, "all slots of alice once, in primary key order");
+    t.equal(reads.size(), size_t(4), "resumed pages");
+    // a resumed page seeks the cursor row instead of walking the rows sharing its key
+    for (size_t i = 1; i < reads.size(); ++i)
+        t.expect(reads[i] <= reads[0], "secondary reads of resumed page " + std::to_string(i) + ": "
+                 + std::to_string(reads[i]) + " > " + std::to_string(reads[0]));
+
+    t.section("range/across keys");
+    ids.clear();
+    reads.clear();
+    scan(name(0), name(-1), 3, ids, reads);
+    auto expected = alice_slots;
+    expected.insert(expected.end(), bob_slots.begin(), bob_slots.end());
+    t.expect(ids == expected, "slots of alice then bob, each once");
+
+    t.section("range/bounds");
+    ids.clear();
+    scan("bob"_n, "bob"_n, 10, ids, reads);
+    t.expect(ids == bob_slots, "slots of bob only, in one page");
+    t.fails<stoken>(token_contract, {}, "limit > 100", [&](auto& k) {
+        k.getslots( "alice"_n, 0, 101 );
+    });
+    t.fails<stoken>(token_contract, {}, "range limit must be positive", [&](auto&) {
+        wasm::db::dbc db( token_contract );
+        db.range<"slotowner"_n, slot_t>( token_contract.value, uint64_t(0), uint64_t(-1), 0 );
+    });
+
+    t.section("dbc/duplicate key");
+    // a new row with a taken primary key fails when it is set, not when the cache is flushed
+    t.fails<stoken>(token_contract, {}, "record already exists", [&](auto&) {
+        wasm::db::dbc db( token_contract );
+        db.set( token_contract.value, slot_t( 1 ), false );
+    });
+
+    return t.finish();
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chain.hpp>
+
+#include <eosio/asset.hpp>
+#include <eosio/datastream.hpp>
+
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * Behaviour tests on top of the native chain harness.
+ *
+ * Actions are pushed like on the chain and the rows they wrote are read back
+ * from the store with `row`/`rows`, unpacked into a tuple of the serialized
+ * fields of the row struct:
+ *
+ *    test::suite t("amax.token");
+ *    t.ok<token>( "amax.token"_n, { "alice"_n }, [&]( auto& c ) { c.transfer( ... ); } );
+ *    auto bob = test::row<std::tuple<asset>>( "amax.token"_n, "bob"_n.value, "accounts"_n, code );
+ *    t.equal( std::get<0>( *bob ), asset( 1, sym ), "bob balance" );
+ *
+ * usage: <contract>.test, the exit code is the number of failed expectations
+ */
+namespace test {
+
+using eosio::name;
+
+inline std::string to_text(const eosio::asset& v)   { return v.to_string(); }
+inline std::string to_text(const eosio::name& v)    { return v.to_string(); }
+inline std::string to_text(const std::string& v)    { return v; }
+inline std::string to_text(bool v)                  { return v ? "true" : "false"; }
+
+template<typename T, typename = std::enable_if_t<std::is_integral<T>::value>>
+std::string to_text(T v)                            { return std::to_string(v); }
+
+class suite {
+public:
+    explicit suite(const char* contract): _contract(contract) {
+        harness::chain::get().reset();
+    }
+
+    /// names the following expectations in the failure report
+    void section(const std::string& name) { _section = name; }
+
+    void expect(bool cond, const std::string& what) {
+        ++_checks;
+        if (cond) return;
+        ++_failures;
+        std::printf("%-14s %-24s FAILED: %s\n", _contract, _section.c_str(), what.c_str());
+    }
+
+    template<typename T, typename U>
+    void equal(const T& actual, const U& expected, const std::string& what) {
+        expect(actual == expected, what + ": got " + to_text(actual) + ", expected " + to_text(expected));
+    }
+
+    /// pushes an action that must succeed
+    template<typename Contract, typename Func>
+    const harness::action_result& ok(const name& self, const std::vector<name>& auths, Func&& func) {
+        const auto& r = harness::chain::get().push<Contract>(self, auths, func);
+        expect(!r.failed, "unexpected failure: " + r.error);
+        return r;
+    }
+
+    /// pushes an action that must fail with an error containing `error`
+    template<typename Contract, typename Func>
+    const harness::action_result& fails(const name& self, const std::vector<name>& auths, const std::string& error,
+                                        Func&& func) {
+        const auto& r = harness::chain::get().push<Contract>(self, auths, func);
+        if (!r.failed)
+            expect(false, "expected failure \"" + error + "\", action succeeded");
+        else
+            expect(r.error.find(error) != std::string::npos, "expected failure \"" + error + "\", got \"" + r.error + "\"");
+        return r;
+    }
+
+    /// returns the process exit code: the number of failed expectations
+    int finish() {
+        std::printf("%-14s %d check(s), %d failure(s)\n", _contract, _checks, _failures);
+        return _failures;
+    }
+
+private:
+    const char*     _contract;
+    std::string     _section;
+    int             _checks     = 0;
+    int             _failures   = 0;
+};
+
+inline const harness::store::table* find_table(const name& code, uint64_t scope, const name& table) {
+    for (const auto& t : harness::chain::get().db().tables()) {
+        if (t->id.code == code.value && t->id.scope == scope && t->id.table == table.value)
+            return t.get();
+    }
+    return nullptr;
+}
+
+/// the row `pk` of a table, unpacked into `Row`
+template<typename Row>
+std::optional<Row> row(const name& code, uint64_t scope, const name& table, uint64_t pk) {
+    const auto* t = find_table(code, scope, table);
+    if (t == nullptr) return std::nullopt;
+    auto it = t->rows.find(pk);
+    if (it == t->rows.end()) return std::nullopt;
+    return eosio::unpack<Row>(it->second.data);
+}
+
+/// all rows of a table in primary key order
+template<typename Row>
+std::vector<Row> rows(const name& code, uint64_t scope, const name& table) {
+    std::vector<Row> result;
+    if (const auto* t = find_table(code, scope, table)) {
+        for (const auto& r : t->rows)
+            result.push_back(eosio::unpack<Row>(r.second.data));
+    }
+    return result;
+}
+
+/// the RAM payer of the row `pk` of a table, empty if there is no such row
+inline name payer(const name& code, uint64_t scope, const name& table, uint64_t pk) {
+    const auto* t = find_table(code, scope, table);
+    if (t == nullptr) return name();
+    auto it = t->rows.find(pk);
+    return it == t->rows.end() ? name() : name(it->second.payer);
+}
+
+} //namespace test
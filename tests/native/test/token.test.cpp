@@ -0,0 +1,411 @@
+#include <amax.token/amax.token.hpp>
+
+#include "test.hpp"
+
+using namespace eosio;
+
+static constexpr name   token_contract  = "amax.token"_n;
+static constexpr name   issuer          = "amax"_n;
+static constexpr symbol AMAX            = symbol("AMAX", 8);
+
+static asset amax(int64_t units) { return asset(units * 1'00000000, AMAX); }
+
+static bool has_balance(const name& owner) {
+    return test::row<std::tuple<asset>>(token_contract, owner.value, "accounts"_n, AMAX.code().raw()).has_value();
+}
+
+/// balance of `owner`, zero if the row does not exist
+static asset balance(const name& owner) {
+    auto r = test::row<std::tuple<asset>>(token_contract, owner.value, "accounts"_n, AMAX.code().raw());
+    return r ? std::get<0>(*r) : asset(0, AMAX);
+}
+
+static asset supply() {
+    auto r = test::row<std::tuple<asset, asset, name>>(token_contract, AMAX.code().raw(), "stat"_n, AMAX.code().raw());
+    return r ? std::get<0>(*r) : asset(0, AMAX);
+}
+
+static constexpr symbol OLD             = symbol("OLD", 4);
+
+static asset old(int64_t units) { return asset(units * 1'0000, OLD); }
+
+static bool listed(const name& owner) {
+    return test::row<std::tuple<name, asset>>(token_contract, OLD.code().raw(), "topholders"_n, owner.value).has_value();
+}
+
+static bool blacklisted(const name& account) {
+    return test::row<std::tuple<name>>(token_contract, token_contract.value, "blacklist"_n, account.value).has_value();
+}
+
+int main() {
+    test::suite t("amax.token");
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, issuer, "alice"_n, "bob"_n, "carol"_n, "dave"_n,
+                        "black1"_n, "black2"_n, "black3"_n, "black4"_n, "black5"_n,
+                        "erin"_n, "frank"_n, "gina"_n });
+
+    t.ok<token>(token_contract, { token_contract }, [&](auto& k) {
+        k.create( issuer, amax(10'000'000) );
+    });
+    t.ok<token>(token_contract, { issuer }, [&](auto& k) {
+        k.issue( issuer, amax(1'000'000), "" );
+    });
+    t.ok<token>(token_contract, { issuer }, [&](auto& k) {
+        k.transfer( issuer, "alice"_n, amax(1000), "" );
+    });
+
+    t.section("transfers");
+    const auto notified = t.ok<token>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.transfers( "alice"_n, { { "bob"_n, amax(10), "" }, { "carol"_n, amax(20), "" }, { "bob"_n, amax(5), "" } } );
+    }).recipients;
+    t.expect(notified == std::vector<name>{ "alice"_n, "bob"_n, "carol"_n }, "sender and recipients notified once");
+    t.equal(balance("alice"_n), amax(965), "alice debited the total");
+    t.equal(balance("bob"_n), amax(15), "bob credited twice");
+    t.equal(balance("carol"_n), amax(20), "carol credited");
+
+    t.fails<token>(token_contract, { "alice"_n }, "to account does not exist", [&](auto& k) {
+        k.transfers( "alice"_n, { { "bob"_n, amax(1), "" }, { "nobody"_n, amax(1), "" } } );
+    });
+    t.equal(balance("alice"_n), amax(965), "alice after a failed batch");
+    t.equal(balance("bob"_n), amax(15), "bob after a failed batch");
+    t.fails<token>(token_contract, { "alice"_n }, "overdrawn balance", [&](auto& k) {
+        k.transfers( "alice"_n, { { "bob"_n, amax(900), "" }, { "carol"_n, amax(100), "" } } );
+    });
+    t.fails<token>(token_contract, { "alice"_n }, "no transfers", [&](auto& k) {
+        k.transfers( "alice"_n, {} );
+    });
+    t.fails<token>(token_contract, { "bob"_n }, "missing authority of alice", [&](auto& k) {
+        k.transfers( "alice"_n, { { "bob"_n, amax(1), "" } } );
+    });
+    t.fails<token>(token_contract, { "alice"_n }, "too many transfers: 501", [&](auto& k) {
+        k.transfers( "alice"_n, std::vector<transfer_param>( 501, { "bob"_n, amax(1), "" } ) );
+    });
+
+    t.section("distribute");
+    t.ok<token>(token_contract, { issuer }, [&](auto& k) {
+        k.distribute({ { "carol"_n, amax(7), "" }, { "dave"_n, amax(3), "" } });
+    });
+    t.equal(balance("carol"_n), amax(27), "carol credited");
+    t.equal(balance("dave"_n), amax(3), "dave opened and credited");
+    t.equal(supply(), amax(1'000'010), "supply grows by the total");
+
+    t.fails<token>(token_contract, { "alice"_n }, "missing authority of amax", [&](auto& k) {
+        k.distribute({ { "alice"_n, amax(1), "" } });
+    });
+    t.fails<token>(token_contract, { issuer }, "quantity exceeds available supply", [&](auto& k) {
+        k.distribute({ { "alice"_n, amax(9'000'000), "" }, { "bob"_n, amax(1), "" } });
+    });
+    t.fails<token>(token_contract, { issuer }, "no payouts", [&](auto& k) {
+        k.distribute({});
+    });
+    t.equal(supply(), amax(1'000'010), "supply after failed payouts");
+
+    t.section("settle");
+    // alice -> bob 50, bob -> carol 60, carol -> alice 5: alice -45, bob -10, carol +55
+    t.ok<token>(token_contract, { "alice"_n, "bob"_n, "carol"_n }, [&](auto& k) {
+        k.settle({ { "alice"_n, "bob"_n, amax(50), "" }, { "bob"_n, "carol"_n, amax(60), "" },
+                   { "carol"_n, "alice"_n, amax(5), "" } });
+    });
+    t.equal(balance("alice"_n), amax(920), "alice net debit");
+    t.equal(balance("bob"_n), amax(5), "bob net debit");
+    t.equal(balance("carol"_n), amax(82), "carol net credit");
+
+    // bob only holds 5 but receives before sending, the net amount is what must be covered
+    t.ok<token>(token_contract, { "alice"_n, "bob"_n }, [&](auto& k) {
+        k.settle({ { "bob"_n, "dave"_n, amax(20), "" }, { "alice"_n, "bob"_n, amax(20), "" } });
+    });
+    t.equal(balance("bob"_n), amax(5), "bob passes the transfer through");
+    t.equal(balance("dave"_n), amax(23), "dave credited");
+
+    t.fails<token>(token_contract, { "bob"_n }, "overdrawn balance", [&](auto& k) {
+        k.settle({ { "bob"_n, "dave"_n, amax(6), "" } });
+    });
+    t.fails<token>(token_contract, { "alice"_n }, "missing authority of bob", [&](auto& k) {
+        k.settle({ { "alice"_n, "bob"_n, amax(1), "" }, { "bob"_n, "carol"_n, amax(1), "" } });
+    });
+    t.equal(balance("alice"_n), amax(900), "alice after failed settlements");
+
+    t.section("applyblack");
+    const std::vector<name> first  = { "black1"_n, "black2"_n, "black3"_n, "black4"_n, "black5"_n };
+    const std::vector<name> second = { "black2"_n, "black4"_n };
+    t.ok<token>(token_contract, { token_contract }, [&](auto& k) {
+        k.stageblack( first, true );
+    });
+    t.ok<token>(token_contract, { token_contract }, [&](auto& k) {
+        k.stageblack( second, false );
+    });
+    t.expect(!blacklisted("black1"_n), "staging does not blacklist");
+
+    auto staged = [&]() {
+        return test::rows<std::tuple<uint64_t, name, bool>>(token_contract, token_contract.value, "blackstage"_n);
+    };
+    t.equal(staged().size(), size_t(7), "one staged row per target");
+
+    // applyblack needs no authorization
+    t.ok<token>(token_contract, {}, [&](auto& k) {
+        k.applyblack( 2 );
+    });
+    t.expect(blacklisted("black1"_n) && blacklisted("black2"_n) && !blacklisted("black3"_n), "first chunk applied");
+    auto rows = staged();
+    t.equal(rows.size(), size_t(5), "applied rows erased");
+    if (!rows.empty()) t.equal(std::get<1>(rows.front()), "black3"_n, "next staged target");
+
+    // finishes the first update and resumes into the second one
+    t.ok<token>(token_contract, {}, [&](auto& k) {
+        k.applyblack( 4 );
+    });
+    t.expect(blacklisted("black3"_n) && blacklisted("black5"_n), "first update completed");
+    t.expect(!blacklisted("black2"_n) && blacklisted("black4"_n), "second update started");
+    rows = staged();
+    t.equal(rows.size(), size_t(1), "staged rows left");
+    if (!rows.empty()) t.expect(std::get<1>(rows.front()) == "black4"_n && !std::get<2>(rows.front()), "removal of black4 left");
+
+    t.ok<token>(token_contract, {}, [&](auto& k) {
+        k.applyblack( 10 );
+    });
+    t.expect(!blacklisted("black4"_n), "second update completed");
+    t.equal(staged().size(), size_t(0), "staged rows");
+    t.fails<token>(token_contract, {}, "no staged blacklist change", [&](auto& k) {
+        k.applyblack( 1 );
+    });
+    t.fails<token>(token_contract, { "alice"_n }, "not authorized", [&](auto& k) {
+        k.stageblack( { "alice"_n }, true );
+    });
+
+    t.section("transfer blacklisted");
+    // black1, black3 and black5 are blacklisted; black2 sorts between them and is not
+    t.fails<token>(token_contract, { "alice"_n }, "to acccount blacklisted!", [&](auto& k) {
+        k.transfer( "alice"_n, "black1"_n, amax(1), "" );
+    });
+    t.fails<token>(token_contract, { "carol"_n }, "to acccount blacklisted!", [&](auto& k) {
+        k.transfer( "carol"_n, "black3"_n, amax(1), "" );
+    });
+    t.expect(!has_balance("black1"_n) && !has_balance("black3"_n), "no balance opened for a blacklisted account");
+    t.ok<token>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.transfer( "alice"_n, "black2"_n, amax(10), "" );
+    });
+    t.equal(balance("black2"_n), amax(10), "black2 credited");
+
+    c.create_account( "aaaaaaaaaaaa"_n );
+    t.ok<token>(token_contract, { token_contract }, [&](auto& k) {
+        k.blacklist( { "black2"_n }, true );
+    });
+    t.fails<token>(token_contract, { "black2"_n }, "blacklisted account can only transfer to `aaaaaaaaaaaa`!", [&](auto& k) {
+        k.transfer( "black2"_n, "bob"_n, amax(1), "" );
+    });
+    t.fails<token>(token_contract, { "black2"_n }, "blacklisted account can only transfer to `aaaaaaaaaaaa`!", [&](auto& k) {
+        k.transfer( "black2"_n, "alice"_n, amax(1), "" );
+    });
+    t.ok<token>(token_contract, { "black2"_n }, [&](auto& k) {
+        k.transfer( "black2"_n, "aaaaaaaaaaaa"_n, amax(4), "" );
+    });
+    t.expect(blacklisted("black2"_n), "still blacklisted after a partial transfer");
+    t.ok<token>(token_contract, { "black2"_n }, [&](auto& k) {
+        k.transfer( "black2"_n, "aaaaaaaaaaaa"_n, amax(6), "" );
+    });
+    t.expect(!blacklisted("black2"_n), "removed from the blacklist after sending its whole balance");
+    t.equal(balance("aaaaaaaaaaaa"_n), amax(10), "aaaaaaaaaaaa credited");
+
+    t.section("sweep");
+    t.ok<token>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.openmany( { "erin"_n, "frank"_n, "gina"_n, "alice"_n }, AMAX, "alice"_n );
+    });
+    for (auto owner : { "erin"_n, "frank"_n, "gina"_n })
+        t.equal(test::payer(token_contract, owner.value, "accounts"_n, AMAX.code().raw()), "alice"_n,
+                owner.to_string() + " opened at the expense of alice");
+    t.equal(balance("alice"_n), amax(890), "alice's own balance left as is");
+
+    // frank is credited and keeps the row paid by alice, erin spends and pays for hers
+    t.ok<token>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.transfers( "alice"_n, { { "frank"_n, amax(5), "" }, { "erin"_n, amax(1), "" } } );
+    });
+    t.ok<token>(token_contract, { "erin"_n }, [&](auto& k) {
+        k.transfer( "erin"_n, "alice"_n, amax(1), "" );
+    });
+    t.equal(test::payer(token_contract, "erin"_n.value, "accounts"_n, AMAX.code().raw()), "erin"_n, "erin pays once spending");
+
+    t.ok<token>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.sweep( "alice"_n, AMAX, { "erin"_n, "frank"_n, "gina"_n, "bob"_n, "nobody"_n } );
+    });
+    t.expect(!has_balance("gina"_n), "empty balance opened by alice closed");
+    t.expect(has_balance("erin"_n), "empty balance paid by its owner kept");
+    t.expect(has_balance("frank"_n), "balance in use kept");
+    t.expect(has_balance("bob"_n), "balance of another payer kept");
+
+    t.ok<token>(token_contract, { "bob"_n }, [&](auto& k) {
+        k.sweep( "bob"_n, AMAX, { "erin"_n } );
+    });
+    t.expect(has_balance("erin"_n), "not closed by a third account");
+    t.ok<token>(token_contract, { "erin"_n }, [&](auto& k) {
+        k.sweep( "erin"_n, AMAX, { "erin"_n } );
+    });
+    t.expect(!has_balance("erin"_n), "closed by its owner");
+
+    t.ok<token>(token_contract, { "frank"_n }, [&](auto& k) {
+        k.transfer( "frank"_n, "alice"_n, amax(5), "" );
+    });
+    t.ok<token>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.sweep( "alice"_n, AMAX, { "frank"_n } );
+    });
+    t.expect(has_balance("frank"_n), "emptied by its owner, now paid by it, kept");
+
+    t.fails<token>(token_contract, { "bob"_n }, "missing authority of alice", [&](auto& k) {
+        k.sweep( "alice"_n, AMAX, { "frank"_n } );
+    });
+    t.fails<token>(token_contract, { "alice"_n }, "no owners", [&](auto& k) {
+        k.sweep( "alice"_n, AMAX, {} );
+    });
+    t.fails<token>(token_contract, { "alice"_n }, "too many owners: 501", [&](auto& k) {
+        k.sweep( "alice"_n, AMAX, std::vector<name>( 501, "frank"_n ) );
+    });
+
+    t.section("getbalances");
+    std::vector<balance_info> balances;
+    t.ok<token>(token_contract, {}, [&](auto& k) {
+        balances = k.getbalances( { "alice"_n, "nobody"_n, "bob"_n }, { AMAX.code(), symbol_code("NONE") } );
+    });
+    t.equal(balances.size(), size_t(2), "existing balances only");
+    if (balances.size() == 2) {
+        t.equal(balances[0].owner, "alice"_n, "first owner");
+        t.equal(balances[1].balance, balance("bob"_n), "bob balance");
+    }
+    // rejected on its size even though the product of the sizes is 0
+    t.fails<token>(token_contract, {}, "too many balances queried", [&](auto& k) {
+        k.getbalances( std::vector<name>( 1001, "alice"_n ), {} );
+    });
+
+    t.section("settle blacklisted");
+    t.fails<token>(token_contract, { "alice"_n }, "account blacklisted: black1", [&](auto& k) {
+        k.settle({ { "alice"_n, "black1"_n, amax(1), "" } });
+    });
+    t.expect(!has_balance("black1"_n), "no balance opened for a blacklisted account");
+
+    t.section("getholders");
+    // positive balances: amax 999000, alice 890, carol 82, dave 23, aaaaaaaaaaaa 10, bob 5
+    holders_info holders;
+    t.ok<token>(token_contract, {}, [&](auto& k) {
+        holders = k.getholders( AMAX.code(), 4 );
+    });
+    t.equal(holders.holders, uint64_t(6), "holders after balances emptied by transfer, sweep and blacklist");
+    const std::vector<name> largest = { issuer, "alice"_n, "carol"_n, "dave"_n };
+    t.equal(holders.top.size(), largest.size(), "top holders within the limit");
+    for (size_t i = 0; i < holders.top.size() && i < largest.size(); ++i) {
+        t.equal(holders.top[i].owner, largest[i], "top holder " + std::to_string(i));
+        t.equal(holders.top[i].balance, balance(largest[i]), "balance of top holder " + std::to_string(i));
+    }
+    t.ok<token>(token_contract, {}, [&](auto& k) {
+        holders = k.getholders( AMAX.code(), 100 );
+    });
+    t.equal(holders.top.size(), size_t(6), "every holder listed");
+    t.fails<token>(token_contract, {}, "too many holders queried", [&](auto& k) {
+        k.getholders( AMAX.code(), 101 );
+    });
+
+    t.section("seedholders");
+    // a token created before holders were tracked has no holderstats row
+    t.ok<token>(token_contract, { token_contract }, [&](auto& k) {
+        k.create( issuer, old(1'000'000) );
+    });
+    t.ok<token>(token_contract, { token_contract }, [&](auto&) {
+        auto itr = internal_use_do_not_use::db_find_i64( token_contract.value, OLD.code().raw(),
+                                                         "holderstats"_n.value, "holderstats"_n.value );
+        internal_use_do_not_use::db_remove_i64( itr );
+    });
+    t.ok<token>(token_contract, { issuer }, [&](auto& k) {
+        k.issue( issuer, old(1000), "" );
+    });
+    t.ok<token>(token_contract, { issuer }, [&](auto& k) {
+        k.transfers( issuer, { { "alice"_n, old(300), "" }, { "bob"_n, old(200), "" }, { "carol"_n, old(100), "" } } );
+    });
+    t.ok<token>(token_contract, { "carol"_n }, [&](auto& k) {
+        k.transfer( "carol"_n, "alice"_n, old(100), "" );
+    });
+    t.expect(!listed(issuer) && !listed("alice"_n), "nothing tracked before seeding");
+    t.fails<token>(token_contract, {}, "holders of OLD are not initialized, run seedholders", [&](auto& k) {
+        k.getholders( OLD.code(), 10 );
+    });
+
+    t.ok<token>(token_contract, { token_contract }, [&](auto& k) {
+        k.seedholders( OLD.code(), { "aaaaaaaaaaaa"_n, "alice"_n, issuer }, false );
+    });
+    t.expect(listed(issuer) && listed("alice"_n), "seeded balances listed");
+    // alice is tracked from now on, bob is read with the next batch
+    t.ok<token>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.transfer( "alice"_n, "bob"_n, old(50), "" );
+    });
+    t.expect(!listed("bob"_n), "owners past the cursor not tracked yet");
+    t.fails<token>(token_contract, {}, "not initialized", [&](auto& k) {
+        k.getholders( OLD.code(), 10 );
+    });
+    t.fails<token>(token_contract, { token_contract }, "owners must ascend past amax", [&](auto& k) {
+        k.seedholders( OLD.code(), { "alice"_n }, false );
+    });
+    t.fails<token>(token_contract, { "alice"_n }, "missing authority of amax.token", [&](auto& k) {
+        k.seedholders( OLD.code(), { "bob"_n }, false );
+    });
+
+    t.ok<token>(token_contract, { token_contract }, [&](auto& k) {
+        k.seedholders( OLD.code(), { "bob"_n, "carol"_n, "dave"_n }, true );
+    });
+    t.ok<token>(token_contract, {}, [&](auto& k) {
+        holders = k.getholders( OLD.code(), 10 );
+    });
+    // amax 400, alice 350, bob 250; carol is empty and dave has no balance
+    t.equal(holders.holders, uint64_t(3), "seeded holders");
+    const std::vector<asset> seeded = { old(400), old(350), old(250) };
+    t.equal(holders.top.size(), seeded.size(), "seeded top holders");
+    for (size_t i = 0; i < holders.top.size() && i < seeded.size(); ++i)
+        t.equal(holders.top[i].balance, seeded[i], "seeded top holder " + std::to_string(i));
+    t.fails<token>(token_contract, { token_contract }, "holders of OLD are already initialized", [&](auto& k) {
+        k.seedholders( OLD.code(), { "erin"_n }, true );
+    });
+
+    t.ok<token>(token_contract, { "bob"_n }, [&](auto& k) {
+        k.transfer( "bob"_n, "carol"_n, old(250), "" );
+    });
+    t.expect(!listed("bob"_n) && listed("carol"_n), "emptied balance unlisted, new one listed");
+
+    t.section("topholders full");
+    // 98 balances of 1 fill the list at 100 rows, the last one is left out
+    std::vector<name> minnows;
+    for (int k = 0; k < 98; ++k) {
+        minnows.push_back( name( std::string("minnow") + char('a' + k / 26) + char('a' + k % 26) ) );
+        c.create_account( minnows.back() );
+    }
+    std::vector<transfer_param> ones;
+    for (const auto& m : minnows) ones.push_back({ m, old(1), "" });
+    t.ok<token>(token_contract, { issuer }, [&](auto& k) {
+        k.transfers( issuer, ones );
+    });
+    t.equal(test::rows<std::tuple<name, asset>>(token_contract, OLD.code().raw(), "topholders"_n).size(), size_t(100),
+            "top holders bounded");
+    t.expect(listed(minnows[96]) && !listed(minnows[97]), "balance not above the smallest listed one left out");
+
+    // a larger balance displaces the smallest listed one, the first of the ties
+    t.ok<token>(token_contract, { issuer }, [&](auto& k) {
+        k.transfer( issuer, minnows[97], old(1), "" );
+    });
+    t.expect(listed(minnows[97]) && !listed(minnows[0]), "grown balance displaces the smallest");
+
+    // an emptied listed balance leaves room for the next unlisted balance that changes
+    t.ok<token>(token_contract, { minnows[1] }, [&](auto& k) {
+        k.transfer( minnows[1], "alice"_n, old(1), "" );
+    });
+    t.expect(!listed(minnows[1]), "emptied balance unlisted");
+    t.ok<token>(token_contract, { issuer }, [&](auto& k) {
+        k.transfer( issuer, minnows[0], old(1), "" );
+    });
+    t.expect(listed(minnows[0]), "free row taken");
+    t.ok<token>(token_contract, {}, [&](auto& k) {
+        holders = k.getholders( OLD.code(), 100 );
+    });
+    t.equal(holders.holders, uint64_t(100), "holders after one balance emptied");
+    t.equal(holders.top.size(), size_t(100), "top holders full again");
+    if (!holders.top.empty()) {
+        t.equal(holders.top.front().owner, "alice"_n, "largest holder");
+        t.equal(holders.top.back().balance, old(1), "smallest listed balance");
+    }
+
+    return t.finish();
+}
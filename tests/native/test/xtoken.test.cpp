@@ -0,0 +1,295 @@
+#include <amax.xtoken/amax.xtoken.hpp>
+
+#include "test.hpp"
+
+using namespace eosio;
+using amax_xtoken::xtoken;
+
+static constexpr name   token_contract  = "amax.xtoken"_n;
+static constexpr name   issuer          = "issuer"_n;
+static constexpr name   fee_receiver    = "feereceiver"_n;
+static constexpr symbol XT              = symbol("XT", 4);
+
+/// `tenths` tenths of a token
+static asset xt(int64_t tenths) { return asset(tenths * 1000, XT); }
+
+using account_row = std::tuple<asset, bool, bool>;     // balance, is_frozen, is_fee_exempt
+
+static account_row account_of(const name& owner) {
+    auto r = test::row<account_row>(token_contract, owner.value, "accounts"_n, XT.code().raw());
+    return r ? *r : account_row{ asset(0, XT), false, false };
+}
+
+static asset balance(const name& owner) { return std::get<0>(account_of(owner)); }
+
+using fee_row = std::tuple<uint64_t, uint64_t, asset, uint64_t, uint64_t, uint64_t, uint32_t>;
+// id, epoch, fees, taxed, zero fee and exempt transfers, epoch_secs
+
+static fee_row fee_stats_of(uint64_t id) {
+    auto r = test::row<fee_row>(token_contract, XT.code().raw(), "feestats"_n, id);
+    return r ? *r : fee_row{ id, 0, asset(0, XT), 0, 0, 0, 0 };
+}
+
+int main() {
+    test::suite t("amax.xtoken");
+
+    auto& c = harness::chain::get();
+    c.create_accounts({ token_contract, issuer, fee_receiver, "alice"_n, "bob"_n, "carol"_n, "dave"_n });
+
+    t.ok<xtoken>(token_contract, { token_contract }, [&](auto& k) {
+        k.create( issuer, xt(100'000'000) );
+    });
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.issue( issuer, xt(10'000'000), "" );
+    });
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.feereceiver( XT, fee_receiver );
+    });
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.feeratio( XT, 30 );   // 0.3%
+    });
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.transfer( issuer, "alice"_n, xt(10000), "" );
+    });
+    t.equal(balance("alice"_n), xt(9970), "alice receives net of the fee");
+    t.equal(balance(fee_receiver), xt(30), "fee receiver credited");
+
+    t.section("transfers");
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.open( "carol"_n, XT, issuer );
+    });
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.feeexempt( XT, "carol"_n, true );
+    });
+
+    asset fees;
+    const auto& r = t.ok<xtoken>(token_contract, { "alice"_n }, [&](auto& k) {
+        fees = k.transfers( "alice"_n, { { "bob"_n, xt(1000), "" }, { "carol"_n, xt(1000), "" },
+                                         { fee_receiver, xt(100), "" } } );
+    });
+    t.equal(fees, xt(3), "fees returned");
+    t.equal(r.inline_actions.size(), size_t(1), "one fee notification for the batch");
+    t.equal(balance("alice"_n), xt(7870), "alice debited the gross total");
+    t.equal(balance("bob"_n), xt(997), "bob credited net of the fee");
+    t.equal(balance("carol"_n), xt(1000), "exempt carol credited in full");
+    t.equal(balance(fee_receiver), xt(133), "fee receiver credited its payout and the fees");
+
+    t.fails<xtoken>(token_contract, { "alice"_n }, "to account does not exist", [&](auto& k) {
+        k.transfers( "alice"_n, { { "bob"_n, xt(10), "" }, { "nobody"_n, xt(10), "" } } );
+    });
+    t.fails<xtoken>(token_contract, { "alice"_n }, "cannot transfer to self", [&](auto& k) {
+        k.transfers( "alice"_n, { { "alice"_n, xt(10), "" } } );
+    });
+    t.equal(balance("alice"_n), xt(7870), "alice after failed batches");
+    t.equal(balance("bob"_n), xt(997), "bob after failed batches");
+
+    t.section("freezeaccts");
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.freezeaccts( XT, { "bob"_n, "carol"_n }, true );
+    });
+    t.expect(std::get<1>(account_of("bob"_n)) && std::get<1>(account_of("carol"_n)), "bob and carol frozen");
+    t.expect(std::get<2>(account_of("carol"_n)), "carol still fee exempt");
+
+    std::vector<amax_xtoken::balance_info> flags;
+    t.ok<xtoken>(token_contract, { "alice"_n }, [&](auto& k) {
+        flags = k.getbalances( { "bob"_n, "carol"_n, "dave"_n }, { XT.code() } );
+    });
+    t.equal(flags.size(), size_t(2), "balances of existing rows");
+    if (flags.size() == 2) {
+        t.expect(flags[0].is_frozen && !flags[0].is_fee_exempt, "bob flags");
+        t.expect(flags[1].is_frozen && flags[1].is_fee_exempt, "carol flags");
+    }
+
+    t.fails<xtoken>(token_contract, { "bob"_n }, "from account is frozen", [&](auto& k) {
+        k.transfer( "bob"_n, "alice"_n, xt(10), "" );
+    });
+    t.fails<xtoken>(token_contract, { "alice"_n }, "to account is frozen", [&](auto& k) {
+        k.transfers( "alice"_n, { { "dave"_n, xt(10), "" }, { "bob"_n, xt(10), "" } } );
+    });
+    t.equal(balance("dave"_n), asset(0, XT), "no payout from a failed batch");
+
+    t.fails<xtoken>(token_contract, { issuer }, "account of token does not exist: dave", [&](auto& k) {
+        k.freezeaccts( XT, { "bob"_n, "dave"_n }, false );
+    });
+    t.expect(std::get<1>(account_of("bob"_n)), "bob still frozen after a failed batch");
+    t.fails<xtoken>(token_contract, { "alice"_n }, "missing authority of issuer", [&](auto& k) {
+        k.freezeaccts( XT, { "bob"_n }, false );
+    });
+
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.freezeaccts( XT, { "bob"_n, "carol"_n }, false );
+    });
+    t.expect(!std::get<1>(account_of("bob"_n)) && !std::get<1>(account_of("carol"_n)), "bob and carol unfrozen");
+    t.ok<xtoken>(token_contract, { "bob"_n }, [&](auto& k) {
+        k.transfer( "bob"_n, "carol"_n, xt(10), "" );
+    });
+    t.equal(balance("carol"_n), xt(1010), "carol credited after unfreezing");
+
+    // bob pays for his row since his transfer; a batch with his flag unchanged leaves it so,
+    // the single action bills the row to the issuer as it always did
+    const auto bob_payer = [&]() { return test::payer(token_contract, "bob"_n.value, "accounts"_n, XT.code().raw()); };
+    t.equal(bob_payer(), "bob"_n, "bob pays for his row");
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.freezeaccts( XT, { "bob"_n }, false );
+    });
+    t.equal(bob_payer(), "bob"_n, "unchanged flag skipped by the batch");
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.freezeacct( XT, "bob"_n, false );
+    });
+    t.equal(bob_payer(), issuer, "single action bills the issuer");
+    t.fails<xtoken>(token_contract, { issuer }, "account of token does not exist", [&](auto& k) {
+        k.freezeacct( XT, "dave"_n, true );
+    });
+
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.feeexempts( XT, { "alice"_n, "carol"_n }, false );
+    });
+    t.expect(!std::get<2>(account_of("carol"_n)), "carol no longer fee exempt");
+
+    t.section("claimfees");
+    auto accrued = [&]() {
+        std::vector<amax_xtoken::supply_info> supplies;
+        t.ok<xtoken>(token_contract, {}, [&](auto& k) {
+            supplies = k.getsupplies( { XT.code() } );
+        });
+        return supplies.size() == 1 ? supplies[0].accrued_fees : asset(-1, XT);
+    };
+
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.feeaccrual( XT, true );
+    });
+    t.ok<xtoken>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.transfer( "alice"_n, "bob"_n, xt(1000), "" );
+    });
+    t.ok<xtoken>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.transfers( "alice"_n, { { "bob"_n, xt(1000), "" }, { "carol"_n, xt(1000), "" } } );
+    });
+    t.equal(accrued(), xt(9), "fees accrued by transfer and transfers");
+    t.equal(balance(fee_receiver), xt(133), "fee receiver not credited while accruing");
+    t.equal(balance("bob"_n), xt(2981), "bob credited net of the fees");
+
+    t.fails<xtoken>(token_contract, { issuer }, "accrued fees must be claimed before changing fee_receiver", [&](auto& k) {
+        k.feereceiver( XT, "dave"_n );
+    });
+    t.fails<xtoken>(token_contract, { issuer }, "accrued fees must be claimed before turning off accrual", [&](auto& k) {
+        k.feeaccrual( XT, false );
+    });
+    t.fails<xtoken>(token_contract, { "alice"_n }, "missing authority of fee_receiver or issuer", [&](auto& k) {
+        k.claimfees( XT );
+    });
+
+    asset claimed;
+    t.ok<xtoken>(token_contract, { fee_receiver }, [&](auto& k) {
+        claimed = k.claimfees( XT );
+    });
+    t.equal(claimed, xt(9), "claimed the accrued total");
+    t.equal(balance(fee_receiver), xt(142), "fee receiver paid out");
+    t.equal(accrued(), xt(0), "accrued fees zeroed");
+    t.fails<xtoken>(token_contract, { fee_receiver }, "no accrued fees", [&](auto& k) {
+        k.claimfees( XT );
+    });
+
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.feeaccrual( XT, false );
+    });
+    t.fails<xtoken>(token_contract, { fee_receiver }, "fee accrual mode is off", [&](auto& k) {
+        k.claimfees( XT );
+    });
+    // the stats row still stores the extension, as an empty asset, and the fee is paid out again
+    t.ok<xtoken>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.transfer( "alice"_n, "bob"_n, xt(1000), "" );
+    });
+    t.equal(balance(fee_receiver), xt(145), "fee receiver credited after accrual");
+    t.equal(accrued(), xt(0), "nothing accrued after accrual");
+
+    t.section("feestats");
+    auto fee_totals = [&]() {
+        amax_xtoken::fee_stats_info info;
+        t.ok<xtoken>(token_contract, {}, [&](auto& k) {
+            info = k.getfeestats( XT.code() );
+        });
+        return info;
+    };
+    // fee statistics are opt-in, the fee transfers so far wrote none
+    t.equal(test::rows<fee_row>(token_contract, XT.code().raw(), "feestats"_n).size(), size_t(0), "no statistics rows");
+
+    t.fails<xtoken>(token_contract, { issuer }, "epoch must be 0 or at least 3600 seconds", [&](auto& k) {
+        k.feeepoch( XT, 60 );
+    });
+    t.fails<xtoken>(token_contract, { "alice"_n }, "missing authority of issuer", [&](auto& k) {
+        k.feeepoch( XT, 3600 );
+    });
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.feeepoch( XT, 3600 );
+    });
+    t.equal(fee_totals().epoch_secs, 3600u, "epoch length");
+
+    // hour 900005 since 1970, counted in ring row 1 + 900005 % 90
+    c.set_time( time_point( seconds( 3'240'018'007 ) ) );
+    // 0.3% of 0.01 XT rounds to 0, the issuer and the fee receiver are exempt
+    t.ok<xtoken>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.transfers( "alice"_n, { { "bob"_n, xt(1000), "" }, { "bob"_n, asset(100, XT), "" },
+                                  { fee_receiver, xt(10), "" }, { issuer, xt(10), "" } } );
+    });
+    t.ok<xtoken>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.transfer( "alice"_n, "dave"_n, asset(100, XT), "" );
+    });
+
+    auto hour = fee_stats_of(6);
+    t.equal(std::get<1>(hour), uint64_t(3'240'018'000), "start of the hour");
+    t.equal(std::get<2>(hour), xt(3), "fees of the hour");
+    t.equal(std::get<3>(hour), uint64_t(1), "taxed transfers of the hour");
+    t.equal(std::get<4>(hour), uint64_t(2), "zero fee transfers of the hour");
+    t.equal(std::get<5>(hour), uint64_t(2), "exempt transfers of the hour");
+    t.equal(std::get<6>(hour), 3600u, "length of the hour");
+    t.expect(!test::row<fee_row>(token_contract, XT.code().raw(), "feestats"_n, 0), "no retired totals yet");
+
+    auto totals = fee_totals();
+    t.equal(totals.fees, xt(3), "total fees");
+    t.equal(totals.taxed_transfers, uint64_t(1), "total taxed transfers");
+    t.equal(totals.zero_fee_transfers, uint64_t(2), "total zero fee transfers");
+    t.equal(totals.exempt_transfers, uint64_t(2), "total exempt transfers");
+
+    // 90 hours later the same row is reused, its old hour moves to the retired totals
+    c.produce( seconds( 90 * 3600 ) );
+    t.ok<xtoken>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.transfer( "alice"_n, "bob"_n, xt(1000), "" );
+    });
+    hour = fee_stats_of(6);
+    t.equal(std::get<1>(hour), uint64_t(3'240'018'000 + 90 * 3600), "ring row moved to the new hour");
+    t.equal(std::get<2>(hour), xt(3), "ring row reset before counting");
+    t.equal(std::get<4>(hour) + std::get<5>(hour), uint64_t(0), "counters of the old hour dropped");
+    const auto retired = fee_stats_of(0);
+    t.equal(std::get<2>(retired), xt(3), "retired fees");
+    t.equal(std::get<3>(retired) + std::get<4>(retired) + std::get<5>(retired), uint64_t(5), "retired transfers");
+    t.equal(test::rows<fee_row>(token_contract, XT.code().raw(), "feestats"_n).size(), size_t(2),
+            "retired totals and one ring row");
+    t.equal(fee_totals().taxed_transfers, uint64_t(2), "totals keep the retired hour");
+
+    // counting in the same hour leaves the retired totals alone
+    const auto writes = t.ok<xtoken>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.transfer( "alice"_n, "bob"_n, xt(1000), "" );
+    }).db.writes;
+    t.equal(std::get<3>(fee_stats_of(6)), uint64_t(2), "second transfer of the hour");
+    t.equal(std::get<3>(fee_stats_of(0)), std::get<3>(retired), "retired totals unchanged");
+    t.equal(writes, uint64_t(4), "three balances and the ring row written");
+
+    c.produce( seconds( 3600 ) );
+    t.ok<xtoken>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.transfer( "alice"_n, "bob"_n, xt(1000), "" );
+    });
+    t.equal(std::get<1>(fee_stats_of(7)), uint64_t(3'240'018'000 + 91 * 3600), "next hour in the next row");
+
+    t.ok<xtoken>(token_contract, { issuer }, [&](auto& k) {
+        k.feeepoch( XT, 0 );
+    });
+    t.ok<xtoken>(token_contract, { "alice"_n }, [&](auto& k) {
+        k.transfer( "alice"_n, "bob"_n, xt(1000), "" );
+    });
+    t.equal(std::get<3>(fee_stats_of(7)), uint64_t(1), "epochs no longer counted");
+    totals = fee_totals();
+    t.equal(totals.taxed_transfers, uint64_t(4), "totals kept after counting stopped");
+    t.equal(totals.epoch_secs, 0u, "counting stopped");
+
+    return t.finish();
+}